@@ -0,0 +1,268 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/***********************************************************************************************************************
+*** AccumulatorTable -- group-by accumulators in an open addressing (linear probing) flat hash table
+***********************************************************************************************************************/
+
+// Keys and accumulators are stored inline in one slot array, next to a byte array of 7-bit hash tags that most probes
+// resolve in.  Bulk inserts hash a few keys ahead and prefetch their slots.  For parallel aggregation give every thread
+// its own table and merge() them; that needs Accumulator::merge, which RegressionAccumulator and StatisticsAccumulator
+// have.  for_each_ordered() visits the keys in ascending order for export.
+
+template <typename Key, typename Accumulator = StatisticsAccumulator<double>, typename Hash = std::hash<Key>> struct AccumulatorTable final
+{
+    static_assert(std::is_trivially_copyable_v<Accumulator>, "AccumulatorTable relocates accumulators by copying");
+
+    AccumulatorTable() : count(0), mask(0)
+    {
+    }
+
+    explicit AccumulatorTable(size_t n) : AccumulatorTable()
+    {
+        reserve(n);
+    }
+
+    Accumulator& operator[](Key const& key)  // Inserts a cleared accumulator if the key is new
+    {
+        reserve(count + 1);
+        return locate(key, hash(key)).value;
+    }
+
+    Accumulator const* find(Key const& key) const
+    {
+        if (!count) return nullptr;
+
+        uint64_t const h = hash(key);
+        uint8_t const t = tag_of(h);
+
+        for (size_t i = h & mask; tag[i]; i = (i + 1) & mask)
+        {
+            if (tag[i] == t && slot[i].key == key) return &slot[i].value;
+        }
+        return nullptr;
+    }
+
+    bool erase(Key const& key)  // Backward shift deletion; leaves no tombstones
+    {
+        if (!count) return false;
+
+        uint64_t const h = hash(key);
+        uint8_t const t = tag_of(h);
+        size_t i = h & mask;
+
+        for (; tag[i]; i = (i + 1) & mask)
+        {
+            if (tag[i] == t && slot[i].key == key) break;
+        }
+        if (!tag[i]) return false;
+
+        tag[i] = 0;
+        --count;
+
+        for (size_t j = (i + 1) & mask; tag[j]; j = (j + 1) & mask)
+        {
+            size_t const home = hash(slot[j].key) & mask;
+
+            if (((j - home) & mask) >= ((j - i) & mask))  // Slot 'i' is on the probe path of the entry at 'j'
+            {
+                tag[i] = tag[j];
+                slot[i] = slot[j];
+                tag[j] = 0;
+                i = j;
+            }
+        }
+        return true;
+    }
+
+    template <typename T> AccumulatorTable& insert(Key const* keys, T const* x, size_t n)  // (*this)[keys[i]].insert(x[i])
+    {
+        return batch(keys, n, x);
+    }
+
+    template <typename T> AccumulatorTable& insert(Key const* keys, T const* x, T const* y, size_t n)  // ... insert(x[i], y[i])
+    {
+        return batch(keys, n, x, y);
+    }
+
+    AccumulatorTable& merge(AccumulatorTable const& r)
+    {
+        reserve(count + r.count);
+        for (size_t i = 0; i < r.tag.size(); ++i)
+        {
+            if (r.tag[i]) locate(r.slot[i].key, hash(r.slot[i].key)).value.merge(r.slot[i].value);
+        }
+        return *this;
+    }
+
+    template <typename F> void for_each(F const& f) const  // f(key, accumulator) in storage order
+    {
+        for (size_t i = 0; i < tag.size(); ++i) if (tag[i]) f(slot[i].key, slot[i].value);
+    }
+
+    template <typename F> void for_each_ordered(F const& f) const  // f(key, accumulator) in ascending key order
+    {
+        std::vector<size_t> index;
+        index.reserve(count);
+        for (size_t i = 0; i < tag.size(); ++i) if (tag[i]) index.push_back(i);
+        std::sort(index.begin(), index.end(), [&](size_t a, size_t b) { return slot[a].key < slot[b].key; });
+        for (size_t i : index) f(slot[i].key, slot[i].value);
+    }
+
+    void reserve(size_t n)  // Room for 'n' keys without rehashing
+    {
+        if (n <= capacity() - capacity() / 4) return;
+
+        size_t size = 16;
+        while (size - size / 4 < n) size *= 2;
+
+        std::vector<uint8_t> old_tag(size, 0);
+        std::vector<Slot> old_slot(size);
+
+        old_tag.swap(tag);
+        old_slot.swap(slot);
+        mask = size - 1;
+        count = 0;
+
+        for (size_t i = 0; i < old_tag.size(); ++i)
+        {
+            if (old_tag[i]) locate(old_slot[i].key, hash(old_slot[i].key)).value = old_slot[i].value;
+        }
+    }
+
+    void clear()
+    {
+        std::fill(tag.begin(), tag.end(), uint8_t(0));
+        count = 0;
+    }
+
+    size_t capacity() const
+    {
+        return tag.size();
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+private:
+    struct Slot final
+    {
+        Key key;
+        Accumulator value;
+    };
+
+    static size_t const distance = 8;   // Keys hashed and prefetched ahead in bulk inserts
+    static size_t const block = 256;    // Keys per capacity check in bulk inserts
+
+    static uint64_t hash(Key const& key)  // Finalizer of MurmurHash3, so that identity hashes of integers spread too
+    {
+        uint64_t h = uint64_t(Hash()(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        return h ^ (h >> 33);
+    }
+
+    static uint8_t tag_of(uint64_t h)  // Never zero, which marks an empty slot
+    {
+        return uint8_t(0x80 | (h >> 57));
+    }
+
+    Slot& locate(Key const& key, uint64_t h)  // Finds or inserts; capacity must have been reserved
+    {
+        uint8_t const t = tag_of(h);
+        size_t i = h & mask;
+
+        for (; tag[i]; i = (i + 1) & mask)
+        {
+            if (tag[i] == t && slot[i].key == key) return slot[i];
+        }
+
+        tag[i] = t;
+        slot[i].key = key;
+        slot[i].value = Accumulator();
+        ++count;
+        return slot[i];
+    }
+
+    void prefetch(uint64_t h) const
+    {
+        size_t const i = h & mask;
+#if defined(_MSC_VER)
+        _mm_prefetch(reinterpret_cast<char const*>(&tag[i]), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<char const*>(&slot[i]), _MM_HINT_T0);
+#else
+        __builtin_prefetch(&tag[i]);
+        __builtin_prefetch(&slot[i], 1);
+#endif
+    }
+
+    template <typename... V> AccumulatorTable& batch(Key const* keys, size_t n, V const*... values)
+    {
+        for (size_t i = 0; i < n; i += block)
+        {
+            size_t const end = std::min(n, i + block);
+
+            uint64_t ahead[distance];  // Hashes of keys k ... k + distance - 1 at ahead[k % distance]
+
+            reserve(count + (end - i));
+            for (size_t k = i; k < std::min(end, i + distance); ++k) prefetch(ahead[k % distance] = hash(keys[k]));
+
+            for (size_t k = i; k < end; ++k)
+            {
+                uint64_t const h = ahead[k % distance];
+
+                if (k + distance < end) prefetch(ahead[k % distance] = hash(keys[k + distance]));
+                locate(keys[k], h).value.insert(values[k]...);
+            }
+        }
+        return *this;
+    }
+
+    std::vector<uint8_t> tag;
+    std::vector<Slot> slot;
+    size_t count;
+    size_t mask;
+};
+
+//**********************************************************************************************************************
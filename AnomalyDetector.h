@@ -0,0 +1,212 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "Simd.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/***********************************************************************************************************************
+*** DetectorBank -- z-score and CUSUM anomaly detectors for many streams ticking together, updated in one vector pass
+***********************************************************************************************************************/
+
+// Each stream has an exponentially weighted mean and variance that equal the plain average and population variance of
+// its samples for the first 'window' ticks and then forget with a time constant of 'window' ticks.  A sample is scored
+// against the statistics before it, z = (x - mean) / stdev, and drives the two sided CUSUM of z less 'slack'.  Once
+// 'window' ticks have been seen, a stream alarms if |z| > z_limit or either CUSUM exceeds cusum_limit, which resets
+// its CUSUMs.  The state is kept in one array per quantity, so a tick is a single vectorized pass over the samples
+// and the state, and tick() lists the streams that alarmed.  Samples must be finite.
+
+template <typename T = double> struct DetectorBank final
+{
+	DetectorBank(size_t streams, size_t window, T const& z_limit = T(4), T const& slack = T(0.5), T const& cusum_limit = T(5)) :
+		window(window), z_limit(z_limit), slack(slack), cusum_limit(cusum_limit), n(0),
+		average(streams), variance(streams), cusum_high(streams), cusum_low(streams)
+	{
+		assert(window > 0 && streams <= std::numeric_limits<uint32_t>::max());
+		alarms.reserve(std::min<size_t>(streams, 1024));
+	}
+
+	DetectorBank& clear() noexcept
+	{
+		n = 0;
+		for (auto* s : { &average, &variance, &cusum_high, &cusum_low }) std::fill(s->begin(), s->end(), T(0));
+		alarms.clear();
+		return *this;
+	}
+
+	std::vector<uint32_t> const& tick(T const* x)  // x[i] is the sample of stream 'i'; returns the alarms in order
+	{
+		alarms.clear();
+		++n;
+
+		T const a = T(1) / T(n < window ? n : window);
+
+		if (n <= window) warm(x, a);
+		else detect(x, a);
+
+		return alarms;
+	}
+
+	T mean(size_t i) const noexcept
+	{
+		return average[i];
+	}
+
+	T stdev(size_t i) const noexcept
+	{
+		using std::sqrt;
+		return sqrt(variance[i]);
+	}
+
+	T cusum(size_t i) const noexcept  // The larger of the high and low side CUSUM
+	{
+		return std::max(cusum_high[i], cusum_low[i]);
+	}
+
+	size_t streams() const noexcept
+	{
+		return average.size();
+	}
+
+	size_t ticks() const noexcept
+	{
+		return n;
+	}
+
+private:
+	void warm(T const* x, T const& a) noexcept  // Statistics only
+	{
+		typedef Simd<T> S;
+
+		size_t const m = average.size();
+		T* const mu = average.data();
+		T* const var = variance.data();
+		size_t i = 0;
+
+		if constexpr (S::width > 1)
+		{
+			auto const va = S::set1(a), vb = S::set1(T(1) - a);
+
+			for (; i + S::width <= m; i += S::width)
+			{
+				auto const u = S::load(mu + i);
+				auto const d = S::sub(S::load(x + i), u);
+
+				S::store(mu + i, S::fma(va, d, u));
+				S::store(var + i, S::mul(vb, S::fma(S::mul(va, d), d, S::load(var + i))));
+			}
+		}
+
+		for (; i < m; ++i)
+		{
+			T const d = x[i] - mu[i];
+
+			mu[i] += a * d;
+			var[i] = (T(1) - a) * (var[i] + a * d * d);
+		}
+	}
+
+	void detect(T const* x, T const& a)  // Scores, then updates; alarms where max(|z| - z_limit, CUSUMs - cusum_limit) > 0
+	{
+		typedef Simd<T> S;
+		using std::abs;
+		using std::sqrt;
+
+		size_t const m = average.size();
+		T* const mu = average.data();
+		T* const var = variance.data();
+		T* const hi = cusum_high.data();
+		T* const lo = cusum_low.data();
+		T const tiny = std::numeric_limits<T>::min();  // A constant stream that moves scores infinite, not NaN
+		size_t i = 0;
+
+		if constexpr (S::width > 1)
+		{
+			auto const va = S::set1(a), vb = S::set1(T(1) - a), vk = S::set1(slack), vz = S::set1(z_limit);
+			auto const vh = S::set1(cusum_limit), vt = S::set1(tiny), zero = S::set1(T(0));
+
+			for (; i + S::width <= m; i += S::width)
+			{
+				auto const u = S::load(mu + i);
+				auto const v = S::load(var + i);
+				auto const d = S::sub(S::load(x + i), u);
+				auto const z = S::div(d, S::sqrt(S::max(v, vt)));
+				auto const h = S::max(S::sub(S::add(S::load(hi + i), z), vk), zero);
+				auto const l = S::max(S::sub(S::sub(S::load(lo + i), z), vk), zero);
+				auto const alarm = S::less(zero, S::max(S::sub(S::abs(z), vz), S::sub(S::max(h, l), vh)));
+
+				S::store(mu + i, S::fma(va, d, u));
+				S::store(var + i, S::mul(vb, S::fma(S::mul(va, d), d, v)));
+				S::store(hi + i, S::select(alarm, zero, h));
+				S::store(lo + i, S::select(alarm, zero, l));
+
+				if (S::any(alarm))
+				{
+					unsigned const b = S::bits(alarm);
+					for (size_t j = 0; j < S::width; ++j) if (b >> j & 1) alarms.push_back(uint32_t(i + j));
+				}
+			}
+		}
+
+		for (; i < m; ++i)
+		{
+			T const d = x[i] - mu[i];
+			T const z = d / sqrt(std::max(var[i], tiny));
+
+			mu[i] += a * d;
+			var[i] = (T(1) - a) * (var[i] + a * d * d);
+			hi[i] = std::max(hi[i] + z - slack, T(0));
+			lo[i] = std::max(lo[i] - z - slack, T(0));
+
+			if (abs(z) > z_limit || hi[i] > cusum_limit || lo[i] > cusum_limit)
+			{
+				hi[i] = lo[i] = 0;
+				alarms.push_back(uint32_t(i));
+			}
+		}
+	}
+
+	size_t window;
+	T z_limit;
+	T slack;
+	T cusum_limit;
+	size_t n;                     // Ticks seen
+	std::vector<T> average;       // One entry per stream in each
+	std::vector<T> variance;
+	std::vector<T> cusum_high;
+	std::vector<T> cusum_low;
+	std::vector<uint32_t> alarms;
+};
+
+//**********************************************************************************************************************
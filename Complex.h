@@ -25,25 +25,33 @@ SOFTWARE.
 
 #pragma once
 
+#include "Simd.h"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
 /***********************************************************************************************************************
 *** Complex
 ***********************************************************************************************************************/
 
 template<typename T> struct Complex final
 {
-	Complex() : x(T()), y(T())
+	constexpr Complex() : x(T()), y(T())
 	{
 	}
 
-	template <typename U> Complex(Complex<U> const& r) : x(T(r.x)), y(T(r.y))
+	template <typename U> constexpr Complex(Complex<U> const& r) : x(T(r.x)), y(T(r.y))
 	{
 	}
 
-	Complex(T const& x, T const& y) : x(x), y(y)
+	constexpr Complex(T const& x, T const& y) : x(x), y(y)
 	{
 	}
 
-	template <typename U> Complex& operator=(Complex<U> const& r)
+	template <typename U> constexpr Complex& operator=(Complex<U> const& r)
 	{
 		x = T(r.x);
 		y = T(r.y);
@@ -56,44 +64,454 @@ template<typename T> struct Complex final
 
 //**********************************************************************************************************************
 
-template <typename T> Complex<T> operator+(Complex<T> const& r)
+template <typename T> constexpr Complex<T> operator+(Complex<T> const& r)
 {
 	return { +r.x, +r.y };
 }
 
-template <typename T> Complex<T> operator-(Complex<T> const& r)
+template <typename T> constexpr Complex<T> operator-(Complex<T> const& r)
 {
 	return { -r.x, -r.y };
 }
 
+template <typename T> constexpr Complex<T> operator+(Complex<T> const& r, Complex<T> const& s)
+{
+	return { r.x + s.x, r.y + s.y };
+}
+
+template <typename T> constexpr Complex<T> operator-(Complex<T> const& r, Complex<T> const& s)
+{
+	return { r.x - s.x, r.y - s.y };
+}
+
+template <typename T> constexpr Complex<T> operator*(Complex<T> const& r, Complex<T> const& s)
+{
+	return { r.x * s.x - r.y * s.y, r.x * s.y + r.y * s.x };
+}
+
+template <typename T> constexpr Complex<T> operator/(Complex<T> const& r, Complex<T> const& s)
+{
+	auto d = s.x * s.x + s.y * s.y;
+
+	return { (r.x * s.x + r.y * s.y) / d, (r.y * s.x - r.x * s.y) / d };
+}
+
+template <typename T> constexpr Complex<T> operator+(Complex<T> const& r, T const& s) { return { r.x + s, r.y }; }
+template <typename T> constexpr Complex<T> operator-(Complex<T> const& r, T const& s) { return { r.x - s, r.y }; }
+template <typename T> constexpr Complex<T> operator*(Complex<T> const& r, T const& s) { return { r.x * s, r.y * s }; }
+template <typename T> constexpr Complex<T> operator/(Complex<T> const& r, T const& s) { return { r.x / s, r.y / s }; }
+
+template <typename T> constexpr Complex<T> operator+(T const& r, Complex<T> const& s) { return { r + s.x, s.y }; }
+template <typename T> constexpr Complex<T> operator-(T const& r, Complex<T> const& s) { return { r - s.x, -s.y }; }
+template <typename T> constexpr Complex<T> operator*(T const& r, Complex<T> const& s) { return { r * s.x, r * s.y }; }
+template <typename T> constexpr Complex<T> operator/(T const& r, Complex<T> const& s) { return Complex<T>(r, T()) / s; }
+
 template <typename T> T abs(Complex<T> const& r)
 {
+	using std::sqrt;
+
 	return sqrt(r.x * r.x + r.y * r.y);
 }
 
+template <typename T> T arg(Complex<T> const& r)
+{
+	using std::atan2;
+
+	return atan2(r.y, r.x);
+}
+
+template <typename T> constexpr T norm(Complex<T> const& r)  // Squared magnitude
+{
+	return r.x * r.x + r.y * r.y;
+}
+
+template <typename T> constexpr Complex<T> conj(Complex<T> const& r)
+{
+	return { r.x, -r.y };
+}
+
+static_assert(std::is_trivially_copyable_v<Complex<double>> && std::is_standard_layout_v<Complex<double>>);
+static_assert((Complex<double>(1, 2) * conj(Complex<double>(1, 2))).x == norm(Complex<double>(1, 2)));
+
+template <typename T> void sincos(T const& x, T& s, T& c)  // Both from one call site, which compilers fuse
+{
+	using std::sin; using std::cos;
+
+	s = sin(x);
+	c = cos(x);
+}
+
+template <typename T> void sinhcosh(T const& x, T& sh, T& ch)  // Both from a single exp or expm1 of |x|
+{
+	using std::abs; using std::exp; using std::expm1;
+
+	auto const a = abs(x);
+
+	if (a > 20)
+	{
+		auto const t = exp(a / 2);  // Squared afterwards to postpone overflow
+		ch = t / 2 * t;
+		sh = x < 0 ? -ch : ch;
+		return;
+	}
+
+	auto const e = expm1(a);
+	auto const f = e + 1;
+
+	ch = (f + 1 / f) / 2;
+	sh = e * (e + 2) / (2 * f);
+	if (x < 0) sh = -sh;
+}
+
+template <typename T> Complex<T> cis(T const& y)  // exp(iy)
+{
+	Complex<T> r;
+
+	sincos(y, r.y, r.x);
+
+	return r;
+}
+
 template <typename T> Complex<T> exp(Complex<T> const& r)
 {
-	return { exp(x) * cos(y), exp(x) * sin(y) };
+	using std::exp;
+
+	return exp(r.x) * cis(r.y);
 }
 
 template <typename T> Complex<T> sin(Complex<T> const& r)
 {
-	return { sin(x) * cosh(y), cos(x) * sinh(y) };
+	T s, c, sh, ch;
+
+	sincos(r.x, s, c);
+	sinhcosh(r.y, sh, ch);
+
+	return { s * ch, c * sh };
 }
 
 template <typename T> Complex<T> cos(Complex<T> const& r)
 {
-	return { cos(x) * cosh(y), sin(x) * sinh(y) };
+	T s, c, sh, ch;
+
+	sincos(r.x, s, c);
+	sinhcosh(r.y, sh, ch);
+
+	return { c * ch, -s * sh };
 }
 
 template <typename T> Complex<T> sinh(Complex<T> const& r)
 {
-	return { sinh(x) * cos(y), cosh(x) * sin(y) };
+	T s, c, sh, ch;
+
+	sincos(r.y, s, c);
+	sinhcosh(r.x, sh, ch);
+
+	return { sh * c, ch * s };
 }
 
 template <typename T> Complex<T> cosh(Complex<T> const& r)
 {
-	return { cosh(x) * cos(y), sinh(x) * sin(y) };
+	T s, c, sh, ch;
+
+	sincos(r.y, s, c);
+	sinhcosh(r.x, sh, ch);
+
+	return { ch * c, sh * s };
+}
+
+/***********************************************************************************************************************
+*** ComplexView -- zero-copy interleaved (re, im, re, im, ...) view over Complex<T> or std::complex<T> buffers
+***********************************************************************************************************************/
+
+template <typename T> struct ComplexView final
+{
+	static_assert(sizeof(Complex<T>) == 2 * sizeof(T), "Complex<T> must be layout compatible with T[2]");
+
+	ComplexView(T* p, size_t n) : p(p), n(n)
+	{
+	}
+
+	ComplexView(Complex<T>* p, size_t n) : p(reinterpret_cast<T*>(p)), n(n)
+	{
+	}
+
+	ComplexView(std::complex<T>* p, size_t n) : p(reinterpret_cast<T*>(p)), n(n)
+	{
+	}
+
+	Complex<T> operator[](size_t i) const
+	{
+		return { p[2 * i], p[2 * i + 1] };
+	}
+
+	ComplexView& set(size_t i, Complex<T> const& r)
+	{
+		p[2 * i] = r.x;
+		p[2 * i + 1] = r.y;
+
+		return *this;
+	}
+
+	T* data() const
+	{
+		return p;
+	}
+
+	size_t size() const
+	{
+		return n;
+	}
+
+private:
+	T* p;
+	size_t n;
+};
+
+/***********************************************************************************************************************
+*** ComplexArray -- split (structure of arrays) storage for bulk complex arithmetic
+***********************************************************************************************************************/
+
+template <typename T> struct ComplexArray final
+{
+	ComplexArray()
+	{
+	}
+
+	explicit ComplexArray(size_t n) : re(n), im(n)
+	{
+	}
+
+	explicit ComplexArray(ComplexView<T> const& r) : re(r.size()), im(r.size())
+	{
+		load(r);
+	}
+
+	ComplexArray& load(ComplexView<T> const& r)  // Deinterleave
+	{
+		resize(r.size());
+		for (size_t i = 0; i < r.size(); ++i)
+		{
+			re[i] = r.data()[2 * i];
+			im[i] = r.data()[2 * i + 1];
+		}
+		return *this;
+	}
+
+	ComplexArray const& store(ComplexView<T> const& r) const  // Interleave; the view must hold at least size() items
+	{
+		for (size_t i = 0; i < size(); ++i)
+		{
+			r.data()[2 * i] = re[i];
+			r.data()[2 * i + 1] = im[i];
+		}
+		return *this;
+	}
+
+	ComplexArray& resize(size_t n)
+	{
+		re.resize(n);
+		im.resize(n);
+		return *this;
+	}
+
+	Complex<T> operator[](size_t i) const
+	{
+		return { re[i], im[i] };
+	}
+
+	ComplexArray& set(size_t i, Complex<T> const& r)
+	{
+		re[i] = r.x;
+		im[i] = r.y;
+		return *this;
+	}
+
+	size_t size() const
+	{
+		return re.size();
+	}
+
+	std::vector<T> re;
+	std::vector<T> im;
+};
+
+//**********************************************************************************************************************
+// Bulk kernels.  All operands must have equal size; the output may alias an input.
+
+template <typename T> void multiply(ComplexArray<T>& z, ComplexArray<T> const& a, ComplexArray<T> const& b)  // z = a * b
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	for (; i + S::width <= n; i += S::width)
+	{
+		auto ar = S::load(&a.re[i]), ai = S::load(&a.im[i]);
+		auto br = S::load(&b.re[i]), bi = S::load(&b.im[i]);
+		S::store(&z.re[i], S::sub(S::mul(ar, br), S::mul(ai, bi)));
+		S::store(&z.im[i], S::fma(ar, bi, S::mul(ai, br)));
+	}
+	for (; i < n; ++i) z.set(i, a[i] * b[i]);
+}
+
+template <typename T> void multiply_accumulate(ComplexArray<T>& z, ComplexArray<T> const& a, ComplexArray<T> const& b)  // z += a * b
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	for (; i + S::width <= n; i += S::width)
+	{
+		auto ar = S::load(&a.re[i]), ai = S::load(&a.im[i]);
+		auto br = S::load(&b.re[i]), bi = S::load(&b.im[i]);
+		S::store(&z.re[i], S::sub(S::fma(ar, br, S::load(&z.re[i])), S::mul(ai, bi)));
+		S::store(&z.im[i], S::fma(ai, br, S::fma(ar, bi, S::load(&z.im[i]))));
+	}
+	for (; i < n; ++i) z.set(i, z[i] + a[i] * b[i]);
+}
+
+template <typename T> void conj_multiply(ComplexArray<T>& z, ComplexArray<T> const& a, ComplexArray<T> const& b)  // z = a * conj(b)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	for (; i + S::width <= n; i += S::width)
+	{
+		auto ar = S::load(&a.re[i]), ai = S::load(&a.im[i]);
+		auto br = S::load(&b.re[i]), bi = S::load(&b.im[i]);
+		S::store(&z.re[i], S::fma(ar, br, S::mul(ai, bi)));
+		S::store(&z.im[i], S::sub(S::mul(ai, br), S::mul(ar, bi)));
+	}
+	for (; i < n; ++i) z.set(i, a[i] * conj(b[i]));
+}
+
+template <typename T> void magnitude(T* z, ComplexArray<T> const& a)  // z[i] = abs(a[i]) for all i < a.size()
+{
+	typedef Simd<T> S;
+
+	size_t const n = a.size();
+	size_t i = 0;
+
+	for (; i + S::width <= n; i += S::width)
+	{
+		auto ar = S::load(&a.re[i]), ai = S::load(&a.im[i]);
+		S::store(&z[i], S::sqrt(S::fma(ar, ar, S::mul(ai, ai))));
+	}
+	for (; i < n; ++i) z[i] = abs(a[i]);
+}
+
+//**********************************************************************************************************************
+// Batched elementary functions.  Vector lanes share one exp() between sinh and cosh and one reduction between sin
+// and cos; without vector registers the scalar functions above are used throughout.
+
+template <typename T> void cis(ComplexArray<T>& z, T const* y)  // z[i] = exp(i * y[i]) for all i < z.size()
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c;
+		SimdMath<T>::sincos(S::load(&y[i]), s, c);
+		S::store(&z.re[i], c);
+		S::store(&z.im[i], s);
+	}
+	for (; i < n; ++i) z.set(i, cis(y[i]));
+}
+
+template <typename T> void exp(ComplexArray<T>& z, ComplexArray<T> const& a)  // z = exp(a)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c, e = SimdMath<T>::exp(S::load(&a.re[i]));
+		SimdMath<T>::sincos(S::load(&a.im[i]), s, c);
+		S::store(&z.re[i], S::mul(e, c));
+		S::store(&z.im[i], S::mul(e, s));
+	}
+	for (; i < n; ++i) z.set(i, exp(a[i]));
+}
+
+template <typename T> void sin(ComplexArray<T>& z, ComplexArray<T> const& a)  // z = sin(a)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c, sh, ch;
+		SimdMath<T>::sincos(S::load(&a.re[i]), s, c);
+		SimdMath<T>::sinhcosh(S::load(&a.im[i]), sh, ch);
+		S::store(&z.re[i], S::mul(s, ch));
+		S::store(&z.im[i], S::mul(c, sh));
+	}
+	for (; i < n; ++i) z.set(i, sin(a[i]));
+}
+
+template <typename T> void cos(ComplexArray<T>& z, ComplexArray<T> const& a)  // z = cos(a)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c, sh, ch;
+		SimdMath<T>::sincos(S::load(&a.re[i]), s, c);
+		SimdMath<T>::sinhcosh(S::load(&a.im[i]), sh, ch);
+		S::store(&z.re[i], S::mul(c, ch));
+		S::store(&z.im[i], S::mul(S::mul(s, sh), S::set1(T(-1))));
+	}
+	for (; i < n; ++i) z.set(i, cos(a[i]));
+}
+
+template <typename T> void sinh(ComplexArray<T>& z, ComplexArray<T> const& a)  // z = sinh(a)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c, sh, ch;
+		SimdMath<T>::sincos(S::load(&a.im[i]), s, c);
+		SimdMath<T>::sinhcosh(S::load(&a.re[i]), sh, ch);
+		S::store(&z.re[i], S::mul(sh, c));
+		S::store(&z.im[i], S::mul(ch, s));
+	}
+	for (; i < n; ++i) z.set(i, sinh(a[i]));
+}
+
+template <typename T> void cosh(ComplexArray<T>& z, ComplexArray<T> const& a)  // z = cosh(a)
+{
+	typedef Simd<T> S;
+
+	size_t const n = z.size();
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width)
+	{
+		typename S::type s, c, sh, ch;
+		SimdMath<T>::sincos(S::load(&a.im[i]), s, c);
+		SimdMath<T>::sinhcosh(S::load(&a.re[i]), sh, ch);
+		S::store(&z.re[i], S::mul(ch, c));
+		S::store(&z.im[i], S::mul(sh, s));
+	}
+	for (; i < n; ++i) z.set(i, cosh(a[i]));
 }
 
 //**********************************************************************************************************************
@@ -0,0 +1,257 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Simd.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/***********************************************************************************************************************
+*** CorrelogramAccumulator -- rewindable correlation of x(t - k) with y(t) for every lag k = 0 ... max_lag at once
+***********************************************************************************************************************/
+
+// Lag k behaves like a RegressionAccumulator fed with the pairs (x(t - k), y(t)) of the current window, and insert(x)
+// alone gives the autocorrelation.  Every lag keeps the sums of x, y, xx, yy and xy over its pairs.  A new sample pairs
+// its y with max_lag + 1 earlier x's, so an insert is one vectorized pass adding to the x, xx and xy sums, while the
+// common y and yy terms go to shared scalars; remove is the mirror image.  The sums are of values offset by the window
+// average, re-taken with the sums recomputed each time the window has turned over, so that the cancellation in the
+// variances stays at bay on drifting streams too.  Remove takes out the oldest sample, so the window's samples are kept,
+// in ring buffers that only allocate when the window outgrows them.
+
+template <typename T = double> struct CorrelogramAccumulator final
+{
+	explicit CorrelogramAccumulator(size_t max_lag) : lags(max_lag + 1), n(0), fresh(0), capacity(0), newest(0), oldest(0), shift_x(0), shift_y(0),
+		base_x(0), base_y(0), base_xx(0), base_yy(0), sum_x(lags), sum_y(lags), sum_xx(lags), sum_yy(lags), sum_xy(lags)
+	{
+		reserve(lags);
+	}
+
+	CorrelogramAccumulator& clear() noexcept
+	{
+		n = fresh = 0;
+		base_x = base_y = base_xx = base_yy = 0;
+		for (auto* s : { &sum_x, &sum_y, &sum_xx, &sum_yy, &sum_xy }) std::fill(s->begin(), s->end(), T(0));
+		return *this;
+	}
+
+	CorrelogramAccumulator& insert(T const& x, T const& y)
+	{
+		if (n == 0)
+		{
+			shift_x = x;
+			shift_y = y;
+		}
+		if (n == capacity) reserve(2 * capacity);
+		if (fresh++ >= n) rebase();
+
+		T const dx = x - shift_x, dy = y - shift_y;
+
+		newest = (newest + capacity - 1) & (capacity - 1);
+		history_x[newest] = history_x[newest + capacity] = dx;
+		size_t const tail = (oldest + n) & (capacity - 1);
+		ahead_y[tail] = ahead_y[tail + capacity] = dy;
+		++n;
+
+		// New pairs (x(t - k), y(t)) for k < min(n, lags)
+
+		update(sum_x.data(), sum_xx.data(), sum_y.data(), sum_yy.data(), base_y, base_yy, &history_x[newest], dy, n < lags ? n : lags, T(1));
+		return *this;
+	}
+
+	CorrelogramAccumulator& insert(T const& x)  // Autocorrelation
+	{
+		return insert(x, x);
+	}
+
+	CorrelogramAccumulator& remove()  // The oldest sample
+	{
+		if (n <= 1) return clear();
+
+		// Pairs (x(s), y(s + k)) of the oldest sample 's', for k < min(n, lags)
+
+		T const dx = history_x[(newest + n - 1) & (capacity - 1)];
+
+		update(sum_y.data(), sum_yy.data(), sum_x.data(), sum_xx.data(), base_x, base_xx, &ahead_y[oldest], dx, n < lags ? n : lags, T(-1));
+		oldest = (oldest + 1) & (capacity - 1);
+		--n;
+		return *this;
+	}
+
+	T correlation(size_t k) const noexcept
+	{
+		using std::sqrt;
+
+		assert(k < lags);
+		T const m = T(samples(k));
+		T const sx = base_x + sum_x[k], sy = base_y + sum_y[k], sxx = base_xx + sum_xx[k], syy = base_yy + sum_yy[k];
+		return (m * sum_xy[k] - sx * sy) / sqrt((m * sxx - sx * sx) * (m * syy - sy * sy));
+	}
+
+	T covariance(size_t k) const noexcept  // Population covariance of x(t - k) and y(t)
+	{
+		assert(k < lags);
+		T const m = T(samples(k));
+		return (sum_xy[k] - (base_x + sum_x[k]) * (base_y + sum_y[k]) / m) / m;
+	}
+
+	void correlogram(T* r) const noexcept  // r[k] = correlation(k) for all k <= max_lag()
+	{
+		for (size_t k = 0; k < lags; ++k) r[k] = correlation(k);
+	}
+
+	size_t max_lag() const noexcept
+	{
+		return lags - 1;
+	}
+
+	size_t samples() const noexcept
+	{
+		return n;
+	}
+
+	size_t samples(size_t k) const noexcept  // Pairs at lag 'k'
+	{
+		return n > k ? n - k : 0;
+	}
+
+	void reserve(size_t window)  // Room for a window of this many samples without allocating
+	{
+		size_t size = 16;
+		while (size < window) size *= 2;
+		if (size <= capacity) return;
+
+		std::vector<T> x(2 * size), y(2 * size);
+
+		for (size_t i = 0; i < n; ++i)  // Newest first in x, oldest first in y
+		{
+			x[i] = x[i + size] = history_x[newest + i];
+			y[i] = y[i + size] = ahead_y[oldest + i];
+		}
+
+		history_x.swap(x);
+		ahead_y.swap(y);
+		capacity = size;
+		newest = 0;
+		oldest = 0;
+	}
+
+private:
+	// Adds sign * (a[k], a[k] a[k], c, c c, a[k] c) to the (a, aa, c, cc, xy) sums of lag k for k < m.  The c and cc
+	// terms go to the shared bases; lags at and beyond m, which have no new pair, take them back.
+
+	void update(T* sum_a, T* sum_aa, T* sum_c, T* sum_cc, T& base_c, T& base_cc, T const* a, T const& c, size_t m, T const& sign) noexcept
+	{
+		T* const sum_ac = sum_xy.data();
+		T const sc = sign * c, scc = sign * c * c;
+		size_t k = 0;
+
+		if constexpr (Simd<T>::width > 1)
+		{
+			typedef Simd<T> S;
+
+			auto const vs = S::set1(sign), vsc = S::set1(sc);
+
+			for (; k + S::width <= m; k += S::width)
+			{
+				auto const va = S::load(a + k);
+
+				S::store(sum_a + k, S::fma(va, vs, S::load(sum_a + k)));
+				S::store(sum_aa + k, S::fma(va, S::mul(va, vs), S::load(sum_aa + k)));
+				S::store(sum_ac + k, S::fma(va, vsc, S::load(sum_ac + k)));
+			}
+		}
+
+		for (; k < m; ++k)
+		{
+			sum_a[k] += sign * a[k];
+			sum_aa[k] += a[k] * (a[k] * sign);
+			sum_ac[k] += a[k] * sc;
+		}
+
+		base_c += sc;
+		base_cc += scc;
+		for (k = m; k < lags; ++k)
+		{
+			sum_c[k] -= sc;
+			sum_cc[k] -= scc;
+		}
+	}
+
+	// Moves the offsets to the window average and recomputes the sums by replaying the kept samples as inserts into an
+	// empty window, which also discards the rounding the sums picked up.  O(n min(n, lags)) once per window turnover.
+
+	void rebase() noexcept
+	{
+		if (n == 0) return;
+
+		T const dx = (base_x + sum_x[0]) / T(n), dy = (base_y + sum_y[0]) / T(n);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			size_t const u = (newest + i) & (capacity - 1), v = (oldest + i) & (capacity - 1);
+
+			history_x[u] = history_x[u + capacity] = history_x[u] - dx;
+			ahead_y[v] = ahead_y[v + capacity] = ahead_y[v] - dy;
+		}
+		shift_x += dx;
+		shift_y += dy;
+
+		base_x = base_y = base_xx = base_yy = 0;
+		for (auto* s : { &sum_x, &sum_y, &sum_xx, &sum_yy, &sum_xy }) std::fill(s->begin(), s->end(), T(0));
+
+		for (size_t i = 0; i < n; ++i)  // Oldest first; sample i pairs with the i + 1 before and including it
+		{
+			update(sum_x.data(), sum_xx.data(), sum_y.data(), sum_yy.data(), base_y, base_yy, &history_x[newest + n - 1 - i], ahead_y[oldest + i], i < lags ? i + 1 : lags, T(1));
+		}
+		fresh = 1;
+	}
+
+	size_t lags;
+	size_t n;
+	size_t fresh;     // Samples inserted since the last rebase(), counting the one that triggered it
+	size_t capacity;  // Power of two; both histories are mirrored at [i] and [i + capacity]
+	size_t newest;    // history_x[newest + k] = x(t - k) - shift_x
+	size_t oldest;    // ahead_y[oldest + k] = y(s + k) - shift_y
+	T shift_x;
+	T shift_y;
+	T base_x;         // Sums common to all lags; sum_x[k] etc. hold the differences
+	T base_y;
+	T base_xx;
+	T base_yy;
+	std::vector<T> history_x;
+	std::vector<T> ahead_y;
+	std::vector<T> sum_x;
+	std::vector<T> sum_y;
+	std::vector<T> sum_xx;
+	std::vector<T> sum_yy;
+	std::vector<T> sum_xy;
+};
+
+//**********************************************************************************************************************
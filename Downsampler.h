@@ -0,0 +1,261 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Statistics.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/***********************************************************************************************************************
+*** TimeBucket -- summary of the samples with time stamps in [start, start + width)
+***********************************************************************************************************************/
+
+template <typename T = double> struct TimeBucket final
+{
+    TimeBucket& reset(int64_t t) noexcept
+    {
+        start = t;
+        stats.clear();
+        first = last = 0;
+        lo = std::numeric_limits<T>::infinity();
+        hi = -std::numeric_limits<T>::infinity();
+        first_time = std::numeric_limits<int64_t>::max();
+        last_time = std::numeric_limits<int64_t>::min();
+        return *this;
+    }
+
+    TimeBucket& insert(int64_t t, T const& x) noexcept
+    {
+        stats.insert(x);
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+        if (t < first_time) first_time = t, first = x;
+        if (t >= last_time) last_time = t, last = x;  // Of equal time stamps the last to arrive
+        return *this;
+    }
+
+    TimeBucket& merge(TimeBucket const& r) noexcept
+    {
+        stats.merge(r.stats);
+        lo = std::min(lo, r.lo);
+        hi = std::max(hi, r.hi);
+        if (r.first_time < first_time) first_time = r.first_time, first = r.first;
+        if (r.last_time >= last_time) last_time = r.last_time, last = r.last;
+        return *this;
+    }
+
+    int64_t start;
+    StatisticsAccumulator<T> stats;  // Count, mean and standard deviation
+    T first;
+    T last;
+    T lo;
+    T hi;
+    int64_t first_time;
+    int64_t last_time;
+};
+
+static_assert(std::is_trivially_copyable_v<TimeBucket<double>> && std::is_standard_layout_v<TimeBucket<double>>);
+
+/***********************************************************************************************************************
+*** Downsampler -- streaming (time, value) summaries at several resolutions
+***********************************************************************************************************************/
+
+// Level 0 buckets take samples; a bucket closes once the newest time stamp seen is 'lateness' past its end, and a
+// sample for a closed bucket is dropped (and counted).  Closed buckets are merged into the enclosing bucket of the next
+// coarser level, which closes when all of its finer buckets have, and so on; no level ever revisits samples.  Every
+// level keeps its buckets in a ring sized at construction for 'retention' closed buckets plus the open ones, so rolling
+// over never allocates.  Time stamps are integers in any unit; every width must be a multiple of the previous one, e.g.
+// Downsampler<> d({ { 1000, 3600 }, { 60000, 1440 }, { 3600000, 720 } }, 5000) for 1s, 1m and 1h on milliseconds.
+
+template <typename T = double> struct Downsampler final
+{
+    struct Resolution final
+    {
+        int64_t width;
+        size_t retention;  // Closed buckets kept for for_each()
+    };
+
+    Downsampler(std::initializer_list<Resolution> resolutions, int64_t lateness = 0) : lateness(lateness), watermark(0), dropped(0), started(false)
+    {
+        for (auto const& r : resolutions)
+        {
+            assert(r.width > 0 && (levels.empty() || r.width % levels.back().width == 0));
+
+            int64_t const finer = levels.empty() ? 1 : levels.back().width;
+            size_t const open = size_t((levels.empty() ? lateness : finer) / r.width) + 2;
+
+            levels.push_back({ r.width, std::vector<TimeBucket<T>>(r.retention + open), empty, empty, full });
+            for (auto& b : levels.back().ring) b.start = empty;
+        }
+    }
+
+    Downsampler& insert(int64_t t, T const& x)
+    {
+        return insert(&t, &x, 1);
+    }
+
+    Downsampler& insert(int64_t const* t, T const* x, size_t n)  // In any order; each sample must be within 'lateness'
+    {                                                              // of the newest time stamp before its batch
+        if (n == 0) return *this;
+
+        if (!started)
+        {
+            watermark = t[0];
+            levels[0].closed = floor_div(watermark - lateness, levels[0].width) - 1;
+            started = true;
+        }
+
+        int64_t newest = watermark;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            int64_t const index = floor_div(t[i], levels[0].width);
+
+            if (index <= levels[0].closed)
+            {
+                ++dropped;
+                continue;
+            }
+            bucket(0, index).insert(t[i], x[i]);
+            newest = std::max(newest, t[i]);
+        }
+
+        watermark = newest;
+        close(0, floor_div(watermark - lateness, levels[0].width) - 1);
+        return *this;
+    }
+
+    Downsampler& flush()  // Closes every bucket; the stream may only continue after the current buckets
+    {
+        for (size_t j = 0; j < levels.size(); ++j) close(j, std::max(levels[j].closed, levels[j].newest));
+        return *this;
+    }
+
+    template <typename F> void for_each(size_t level, F const& f, bool open = false) const  // f(bucket), oldest first
+    {
+        auto const& v = levels[level];
+        if (v.newest == empty) return;
+
+        int64_t const last = open ? std::max(v.closed, v.newest) : v.closed;
+        int64_t const first = std::max(last - int64_t(v.ring.size()) + 1, v.oldest);
+
+        for (int64_t index = first; index <= last; ++index)
+        {
+            auto const& b = v.ring[slot(v, index)];
+            if (b.start == index * v.width) f(b);
+        }
+    }
+
+    size_t late() const noexcept  // Samples dropped for arriving after their bucket closed
+    {
+        return dropped;
+    }
+
+    int64_t width(size_t level) const noexcept
+    {
+        return levels[level].width;
+    }
+
+private:
+    static constexpr int64_t empty = std::numeric_limits<int64_t>::min();
+    static constexpr int64_t full = std::numeric_limits<int64_t>::max();
+
+    struct Level final
+    {
+        int64_t width;
+        std::vector<TimeBucket<T>> ring;  // Bucket 'index' lives at ring[index mod ring.size()]
+        int64_t closed;                   // Buckets up to this index are closed
+        int64_t newest;                   // Highest and lowest index that ever had data
+        int64_t oldest;
+    };
+
+    static int64_t floor_div(int64_t a, int64_t b) noexcept
+    {
+        int64_t const q = a / b;
+        return q - (q * b > a);
+    }
+
+    static size_t slot(Level const& v, int64_t index) noexcept
+    {
+        int64_t const size = int64_t(v.ring.size());
+        return size_t(((index % size) + size) % size);
+    }
+
+    TimeBucket<T>& bucket(size_t level, int64_t index)  // Rolls the slot over from the closed bucket it may hold
+    {
+        auto& v = levels[level];
+        int64_t const span = int64_t(v.ring.size());
+
+        if (index - span > v.closed) close(level, index - span);  // Open buckets must not outrun the ring
+
+        auto& b = v.ring[slot(v, index)];
+
+        if (b.start != index * v.width)
+        {
+            b.reset(index * v.width);
+            v.newest = v.newest == empty ? index : std::max(v.newest, index);
+            v.oldest = std::min(v.oldest, index);
+        }
+        return b;
+    }
+
+    void close(size_t level, int64_t through)  // Closes buckets up to 'through' and cascades them
+    {
+        auto& v = levels[level];
+        if (through <= v.closed) return;
+
+        if (level + 1 < levels.size())
+        {
+            for (int64_t index = std::max(v.closed + 1, v.oldest); index <= std::min(through, v.newest); ++index)
+            {
+                auto const& b = v.ring[slot(v, index)];
+                if (b.start == index * v.width) bucket(level + 1, floor_div(b.start, levels[level + 1].width)).merge(b);
+            }
+        }
+        v.closed = through;
+
+        if (level + 1 < levels.size())
+        {
+            int64_t const until = (through + 1) * v.width;  // Everything before this time is final
+            close(level + 1, floor_div(until, levels[level + 1].width) - 1);
+        }
+    }
+
+    std::vector<Level> levels;
+    int64_t lateness;
+    int64_t watermark;  // Newest time stamp seen
+    size_t dropped;
+    bool started;
+};
+
+//**********************************************************************************************************************
@@ -0,0 +1,238 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Forward mode automatic differentiation: a Dual carries a value and its gradient with respect to N independent
+// variables.  Any template in this library instantiated with Dual<T, N> returns the value and the gradient in one pass.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+/***********************************************************************************************************************
+*** Dual
+***********************************************************************************************************************/
+
+template <typename T, size_t N = 1> struct Dual final
+{
+	Dual() : v(), d()
+	{
+	}
+
+	template <typename U, typename = std::enable_if_t<std::is_arithmetic<U>::value>> Dual(U const& r) : v(T(r)), d()  // Constant
+	{
+	}
+
+	Dual(T const& r) : v(r), d()
+	{
+	}
+
+	Dual(T const& r, size_t i) : v(r), d()  // Independent variable number 'i'
+	{
+		d[i] = T(1);
+	}
+
+	Dual& operator+=(Dual const& r) { return *this = *this + r; }
+	Dual& operator-=(Dual const& r) { return *this = *this - r; }
+	Dual& operator*=(Dual const& r) { return *this = *this * r; }
+	Dual& operator/=(Dual const& r) { return *this = *this / r; }
+
+	T v;     // Value
+	T d[N];  // Partial derivatives
+};
+
+//**********************************************************************************************************************
+
+template <typename T, size_t N> Dual<T, N> chain(Dual<T, N> const& r, T const& f, T const& df)  // f(r) given f'(r) = df
+{
+	Dual<T, N> result(f);
+	for (size_t i = 0; i < N; ++i) result.d[i] = df * r.d[i];
+	return result;
+}
+
+template <typename U> using IfArithmetic = std::enable_if_t<std::is_arithmetic<U>::value>;
+
+//**********************************************************************************************************************
+
+template <typename T, size_t N> Dual<T, N> operator+(Dual<T, N> const& r)
+{
+	return r;
+}
+
+template <typename T, size_t N> Dual<T, N> operator-(Dual<T, N> const& r)
+{
+	return chain(r, -r.v, T(-1));
+}
+
+template <typename T, size_t N> Dual<T, N> operator+(Dual<T, N> const& r, Dual<T, N> const& s)
+{
+	Dual<T, N> result(r.v + s.v);
+	for (size_t i = 0; i < N; ++i) result.d[i] = r.d[i] + s.d[i];
+	return result;
+}
+
+template <typename T, size_t N> Dual<T, N> operator-(Dual<T, N> const& r, Dual<T, N> const& s)
+{
+	Dual<T, N> result(r.v - s.v);
+	for (size_t i = 0; i < N; ++i) result.d[i] = r.d[i] - s.d[i];
+	return result;
+}
+
+template <typename T, size_t N> Dual<T, N> operator*(Dual<T, N> const& r, Dual<T, N> const& s)
+{
+	Dual<T, N> result(r.v * s.v);
+	for (size_t i = 0; i < N; ++i) result.d[i] = r.d[i] * s.v + r.v * s.d[i];
+	return result;
+}
+
+template <typename T, size_t N> Dual<T, N> operator/(Dual<T, N> const& r, Dual<T, N> const& s)
+{
+	Dual<T, N> result(r.v / s.v);
+	for (size_t i = 0; i < N; ++i) result.d[i] = (r.d[i] - result.v * s.d[i]) / s.v;
+	return result;
+}
+
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator+(Dual<T, N> const& r, U const& s) { return chain(r, r.v + T(s), T(1)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator-(Dual<T, N> const& r, U const& s) { return chain(r, r.v - T(s), T(1)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator*(Dual<T, N> const& r, U const& s) { return chain(r, r.v * T(s), T(s)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator/(Dual<T, N> const& r, U const& s) { return chain(r, r.v / T(s), 1 / T(s)); }
+
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator+(U const& r, Dual<T, N> const& s) { return chain(s, T(r) + s.v, T(1)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator-(U const& r, Dual<T, N> const& s) { return chain(s, T(r) - s.v, T(-1)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator*(U const& r, Dual<T, N> const& s) { return chain(s, T(r) * s.v, T(r)); }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> operator/(U const& r, Dual<T, N> const& s) { return chain(s, T(r) / s.v, -T(r) / (s.v * s.v)); }
+
+//**********************************************************************************************************************
+// Comparisons look at the value only
+
+template <typename T, size_t N> bool operator<(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v < s.v; }
+template <typename T, size_t N> bool operator>(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v > s.v; }
+template <typename T, size_t N> bool operator<=(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v <= s.v; }
+template <typename T, size_t N> bool operator>=(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v >= s.v; }
+template <typename T, size_t N> bool operator==(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v == s.v; }
+template <typename T, size_t N> bool operator!=(Dual<T, N> const& r, Dual<T, N> const& s) { return r.v != s.v; }
+
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator<(Dual<T, N> const& r, U const& s) { return r.v < s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator>(Dual<T, N> const& r, U const& s) { return r.v > s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator<(U const& r, Dual<T, N> const& s) { return r < s.v; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator>(U const& r, Dual<T, N> const& s) { return r > s.v; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator<=(Dual<T, N> const& r, U const& s) { return r.v <= s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator>=(Dual<T, N> const& r, U const& s) { return r.v >= s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator<=(U const& r, Dual<T, N> const& s) { return r <= s.v; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator>=(U const& r, Dual<T, N> const& s) { return r >= s.v; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator==(Dual<T, N> const& r, U const& s) { return r.v == s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator!=(Dual<T, N> const& r, U const& s) { return r.v != s; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator==(U const& r, Dual<T, N> const& s) { return r == s.v; }
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> bool operator!=(U const& r, Dual<T, N> const& s) { return r != s.v; }
+
+//**********************************************************************************************************************
+
+template <typename T, size_t N> Dual<T, N> abs(Dual<T, N> const& r)
+{
+	return r.v < 0 ? -r : r;
+}
+
+template <typename T, size_t N> Dual<T, N> acos(Dual<T, N> const& r)
+{
+	using std::acos; using std::sqrt;
+	return chain(r, acos(r.v), -1 / sqrt(1 - r.v * r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> cos(Dual<T, N> const& r)
+{
+	using std::cos; using std::sin;
+	return chain(r, cos(r.v), -sin(r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> cosh(Dual<T, N> const& r)
+{
+	using std::cosh; using std::sinh;
+	return chain(r, cosh(r.v), sinh(r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> exp(Dual<T, N> const& r)
+{
+	using std::exp;
+	T const e = exp(r.v);
+	return chain(r, e, e);
+}
+
+template <typename T, size_t N> Dual<T, N> expm1(Dual<T, N> const& r)
+{
+	using std::exp; using std::expm1;
+	return chain(r, expm1(r.v), exp(r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> log(Dual<T, N> const& r)
+{
+	using std::log;
+	return chain(r, log(r.v), 1 / r.v);
+}
+
+template <typename T, size_t N> Dual<T, N> log1p(Dual<T, N> const& r)
+{
+	using std::log1p;
+	return chain(r, log1p(r.v), 1 / (1 + r.v));
+}
+
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> pow(Dual<T, N> const& r, U const& s)
+{
+	using std::pow;
+	return chain(r, pow(r.v, T(s)), T(s) * pow(r.v, T(s) - 1));
+}
+
+template <typename T, size_t N, typename U, typename = IfArithmetic<U>> Dual<T, N> pow(U const& r, Dual<T, N> const& s)
+{
+	using std::log; using std::pow;
+	T const p = pow(T(r), s.v);
+	return chain(s, p, p * log(T(r)));
+}
+
+template <typename T, size_t N> Dual<T, N> pow(Dual<T, N> const& r, Dual<T, N> const& s)
+{
+	return exp(s * log(r));
+}
+
+template <typename T, size_t N> Dual<T, N> sin(Dual<T, N> const& r)
+{
+	using std::cos; using std::sin;
+	return chain(r, sin(r.v), cos(r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> sinh(Dual<T, N> const& r)
+{
+	using std::cosh; using std::sinh;
+	return chain(r, sinh(r.v), cosh(r.v));
+}
+
+template <typename T, size_t N> Dual<T, N> sqrt(Dual<T, N> const& r)
+{
+	using std::sqrt;
+	T const s = sqrt(r.v);
+	return chain(r, s, 1 / (2 * s));
+}
+
+//**********************************************************************************************************************
@@ -0,0 +1,446 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+The mixed radix decomposition and the butterflies are adapted from KISS FFT (https://github.com/mborgerding/kissfft),
+which carries the following notice:
+
+Copyright (c) 2003-2010, Mark Borgerding. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+      disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+      following disclaimer in the documentation and/or other materials provided with the distribution.
+    * Neither the author nor the names of any contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "Complex.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************************************************************************
+*** FFTPlan -- mixed radix (4, 2, 3, generic, Bluestein) discrete Fourier transform of a fixed size
+***********************************************************************************************************************/
+
+// Forward transforms are unnormalized, inverse transforms are scaled by 1 / size().  A plan is immutable once built
+// and may be shared by any number of threads; get() returns plans from a process wide cache keyed by size.
+
+template <typename T> struct FFTPlan final
+{
+	static size_t const parallel_threshold = size_t(1) << 15;  // Transforms at least this long fork their sub-transforms
+	static size_t const bluestein_threshold = 20;  // Prime factors above this go through a power of two convolution (Bluestein)
+
+	explicit FFTPlan(size_t n, unsigned threads = std::thread::hardware_concurrency()) : n(n), threads(std::max(threads, 1u)), tw_fwd(n), tw_inv(n)
+	{
+		assert(n > 0);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			double const phase = -6.28318530717958648 * double(i) / double(n);
+			tw_fwd[i] = Complex<T>(T(std::cos(phase)), T(std::sin(phase)));
+			tw_inv[i] = conj(tw_fwd[i]);
+		}
+
+		size_t p = 4, m = n;
+
+		while (m > 1)
+		{
+			while (m % p)
+			{
+				p = p == 4 ? 2 : p == 2 ? 3 : p + 2;
+				if (p * p > m) p = m;
+			}
+			m /= p;
+			factors.push_back(p);
+			factors.push_back(m);
+
+			if (p > bluestein_threshold && !chirps.count(p))
+			{
+				auto& c = chirps[p];
+				size_t l = 1;
+
+				while (l < 2 * p - 1) l *= 2;
+				c.convolution = std::make_shared<FFTPlan const>(l, 1);
+				c.w.resize(p);
+				c.h_fwd.assign(l, Complex<T>());
+				c.h_inv.assign(l, Complex<T>());
+
+				for (size_t r = 0; r < p; ++r)
+				{
+					double const phase = -3.14159265358979324 * double(r * r % (2 * p)) / double(p);
+					c.w[r] = Complex<T>(T(std::cos(phase)), T(std::sin(phase)));
+					c.h_fwd[r] = conj(c.w[r]) / T(l);
+					c.h_inv[r] = c.w[r] / T(l);
+					if (r) c.h_fwd[l - r] = c.h_fwd[r], c.h_inv[l - r] = c.h_inv[r];
+				}
+				c.convolution->transform(c.h_fwd.data(), c.h_fwd.data(), false, 1);
+				c.convolution->transform(c.h_inv.data(), c.h_inv.data(), false, 1);
+			}
+		}
+	}
+
+	static std::shared_ptr<FFTPlan const> get(size_t n)
+	{
+		static std::mutex lock;
+		static std::map<size_t, std::shared_ptr<FFTPlan const>> cache;
+		thread_local std::map<size_t, std::shared_ptr<FFTPlan const>> local;  // Avoids the lock on repeated sizes
+
+		auto& mine = local[n];
+
+		if (!mine)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto& plan = cache[n];
+			if (!plan) plan = std::make_shared<FFTPlan const>(n);
+			mine = plan;
+		}
+		return mine;
+	}
+
+	void forward(Complex<T> const* in, Complex<T>* out) const  // Out-of-place or, if in == out, in-place
+	{
+		transform(in, out, false);
+	}
+
+	void inverse(Complex<T> const* in, Complex<T>* out) const
+	{
+		transform(in, out, true);
+		for (size_t i = 0; i < n; ++i) out[i] = out[i] / T(n);
+	}
+
+	void forward(Complex<T>* data) const
+	{
+		forward(data, data);
+	}
+
+	void inverse(Complex<T>* data) const
+	{
+		inverse(data, data);
+	}
+
+	void forward(Complex<T> const* in, Complex<T>* out, size_t count) const  // 'count' consecutive transforms
+	{
+		batch(in, out, count, false);
+	}
+
+	void inverse(Complex<T> const* in, Complex<T>* out, size_t count) const
+	{
+		batch(in, out, count, true);
+		for (size_t i = 0; i < n * count; ++i) out[i] = out[i] / T(n);
+	}
+
+	void forward_real(T const* in, Complex<T>* out) const  // Writes size() / 2 + 1 bins; the rest follow by symmetry
+	{
+		if (n % 2)
+		{
+			auto& z = scratch(1);
+			z.resize(n);
+			for (size_t i = 0; i < n; ++i) z[i] = Complex<T>(in[i], T());
+			forward(z.data(), z.data());
+			std::copy(z.begin(), z.begin() + n / 2 + 1, out);
+			return;
+		}
+
+		size_t const h = n / 2;
+
+		get(h)->forward(reinterpret_cast<Complex<T> const*>(in), out);  // Even samples as real, odd as imaginary parts
+
+		Complex<T> const z0 = out[0];
+		out[0] = Complex<T>(z0.x + z0.y, T());
+		out[h] = Complex<T>(z0.x - z0.y, T());
+
+		for (size_t k = 1; 2 * k <= h; ++k)
+		{
+			auto const a = out[k], b = conj(out[h - k]);
+			auto const e = (a + b) * T(0.5), o = (a - b) * Complex<T>(T(), T(-0.5));
+			auto const w = tw_fwd[k] * o, v = tw_fwd[h - k] * conj(o);
+
+			out[k] = e + w;
+			out[h - k] = conj(e) + v;
+		}
+	}
+
+	void inverse_real(Complex<T> const* in, T* out) const  // Reads size() / 2 + 1 bins
+	{
+		if (n % 2)
+		{
+			auto& z = scratch(1);
+			z.resize(n);
+			for (size_t i = 0; i <= n / 2; ++i) z[i] = in[i];
+			for (size_t i = n / 2 + 1; i < n; ++i) z[i] = conj(in[n - i]);
+			inverse(z.data(), z.data());
+			for (size_t i = 0; i < n; ++i) out[i] = z[i].x;
+			return;
+		}
+
+		size_t const h = n / 2;
+		Complex<T>* z = reinterpret_cast<Complex<T>*>(out);
+
+		for (size_t k = 0; k < h; ++k)  // Repack into even samples as real, odd as imaginary parts
+		{
+			auto const a = in[k], b = conj(in[h - k]);
+			auto const e = (a + b) * T(0.5), o = (a - b) * T(0.5) * tw_inv[k];
+
+			z[k] = e + Complex<T>(-o.y, o.x);
+		}
+
+		get(h)->inverse(z, z);
+	}
+
+	size_t size() const
+	{
+		return n;
+	}
+
+private:
+	struct Chirp  // Bluestein: a length p DFT is w[q] times the convolution of x[r] w[r] with conj(w[|j|]), w[r] = W^(r²/2)
+	{
+		std::shared_ptr<FFTPlan const> convolution;  // Power of two length l >= 2p - 1, so the cyclic convolution is exact
+		std::vector<Complex<T>> w;
+		std::vector<Complex<T>> h_fwd;  // Transformed kernels, scaled by 1 / l
+		std::vector<Complex<T>> h_inv;
+	};
+
+	static std::vector<Complex<T>>& scratch(size_t slot)  // 0: in-place input, 1: odd size real transforms, 2: butterfly(), 3-4: bluestein()
+	{
+		thread_local std::vector<Complex<T>> buffer[5];
+		return buffer[slot];
+	}
+
+	void transform(Complex<T> const* in, Complex<T>* out, bool backward, unsigned budget = 0) const
+	{
+		if (in == out)
+		{
+			auto& copy = scratch(0);
+			copy.assign(in, in + n);
+			in = copy.data();
+		}
+
+		if (n == 1) out[0] = in[0];
+		else work(out, in, 1, factors.data(), backward ? tw_inv.data() : tw_fwd.data(), budget ? budget : threads);
+	}
+
+	void batch(Complex<T> const* in, Complex<T>* out, size_t count, bool backward) const
+	{
+		size_t const workers = n * count < parallel_threshold ? 1 : std::min<size_t>(threads, count);
+
+		if (workers < 2)
+		{
+			for (size_t i = 0; i < count; ++i) transform(in + i * n, out + i * n, backward);
+			return;
+		}
+
+		std::vector<std::thread> pool;
+		unsigned const share = std::max(threads / unsigned(workers), 1u);  // Workers split the budget rather than fork again
+
+		for (size_t w = 0; w < workers; ++w)
+		{
+			pool.emplace_back([=]
+			{
+				for (size_t i = w * count / workers; i < (w + 1) * count / workers; ++i) transform(in + i * n, out + i * n, backward, share);
+			});
+		}
+		for (auto& t : pool) t.join();
+	}
+
+	void work(Complex<T>* out, Complex<T> const* in, size_t fstride, size_t const* f, Complex<T> const* tw, unsigned budget) const
+	{
+		size_t const p = f[0], m = f[1];
+
+		if (m == 1)
+		{
+			for (size_t k = 0; k < p; ++k) out[k] = in[k * fstride];
+		}
+		else if (budget > 1 && p * m >= parallel_threshold)
+		{
+			std::vector<std::thread> pool;
+			unsigned const share = std::max(budget / unsigned(p), 1u);
+
+			for (size_t k = 1; k < p; ++k)
+			{
+				pool.emplace_back([=] { work(out + k * m, in + k * fstride, fstride * p, f + 2, tw, share); });
+			}
+			work(out, in, fstride * p, f + 2, tw, share);
+			for (auto& t : pool) t.join();
+		}
+		else
+		{
+			for (size_t k = 0; k < p; ++k) work(out + k * m, in + k * fstride, fstride * p, f + 2, tw, 1);
+		}
+
+		switch (p)
+		{
+		case 2: butterfly2(out, fstride, m, tw); break;
+		case 3: butterfly3(out, fstride, m, tw); break;
+		case 4: butterfly4(out, fstride, m, tw, tw == tw_inv.data()); break;
+		default: p > bluestein_threshold ? bluestein(out, fstride, m, p, tw) : butterfly(out, fstride, m, p, tw); break;
+		}
+	}
+
+	static void butterfly2(Complex<T>* out, size_t fstride, size_t m, Complex<T> const* tw)
+	{
+		for (size_t k = 0; k < m; ++k)
+		{
+			auto const t = out[k + m] * tw[k * fstride];
+			out[k + m] = out[k] - t;
+			out[k] = out[k] + t;
+		}
+	}
+
+	static void butterfly3(Complex<T>* out, size_t fstride, size_t m, Complex<T> const* tw)
+	{
+		T const epi3 = tw[fstride * m].y;
+
+		for (size_t k = 0; k < m; ++k)
+		{
+			auto const s1 = out[k + m] * tw[k * fstride];
+			auto const s2 = out[k + 2 * m] * tw[2 * k * fstride];
+			auto const s3 = s1 + s2;
+			auto const s0 = (s1 - s2) * epi3;
+			auto const h = out[k] - s3 * T(0.5);
+
+			out[k] = out[k] + s3;
+			out[k + m] = Complex<T>(h.x - s0.y, h.y + s0.x);
+			out[k + 2 * m] = Complex<T>(h.x + s0.y, h.y - s0.x);
+		}
+	}
+
+	static void butterfly4(Complex<T>* out, size_t fstride, size_t m, Complex<T> const* tw, bool backward)
+	{
+		for (size_t k = 0; k < m; ++k)
+		{
+			auto const s0 = out[k + m] * tw[k * fstride];
+			auto const s1 = out[k + 2 * m] * tw[2 * k * fstride];
+			auto const s2 = out[k + 3 * m] * tw[3 * k * fstride];
+			auto const s5 = out[k] - s1;
+			auto const a = out[k] + s1;
+			auto const s3 = s0 + s2;
+			auto const s4 = backward ? Complex<T>(-(s0.y - s2.y), s0.x - s2.x) : Complex<T>(s0.y - s2.y, -(s0.x - s2.x));
+
+			out[k] = a + s3;
+			out[k + m] = s5 + s4;
+			out[k + 2 * m] = a - s3;
+			out[k + 3 * m] = s5 - s4;
+		}
+	}
+
+	void butterfly(Complex<T>* out, size_t fstride, size_t m, size_t p, Complex<T> const* tw) const
+	{
+		auto& s = scratch(2);
+		if (s.size() < p) s.resize(p);
+
+		for (size_t u = 0; u < m; ++u)
+		{
+			for (size_t q = 0; q < p; ++q) s[q] = out[u + q * m];
+
+			for (size_t q = 0; q < p; ++q)
+			{
+				size_t const k = u + q * m;
+				size_t index = 0;
+
+				out[k] = s[0];
+				for (size_t r = 1; r < p; ++r)
+				{
+					index += fstride * k;
+					if (index >= n) index %= n;
+					out[k] = out[k] + s[r] * tw[index];
+				}
+			}
+		}
+	}
+
+	void bluestein(Complex<T>* out, size_t fstride, size_t m, size_t p, Complex<T> const* tw) const
+	{
+		auto const& c = chirps.at(p);
+		bool const backward = tw == tw_inv.data();
+		auto const& h = backward ? c.h_inv : c.h_fwd;
+		size_t const l = c.convolution->size();
+		auto& a = scratch(3);
+		auto& b = scratch(4);
+
+		if (a.size() < l) a.resize(l), b.resize(l);
+
+		for (size_t u = 0; u < m; ++u)
+		{
+			size_t index = 0;
+
+			for (size_t r = 0; r < p; ++r)  // Twiddled as in butterfly(), then chirped
+			{
+				a[r] = out[u + r * m] * tw[index] * (backward ? conj(c.w[r]) : c.w[r]);
+				index += fstride * u;
+				if (index >= n) index -= n;
+			}
+			std::fill(a.begin() + p, a.begin() + l, Complex<T>());
+
+			c.convolution->transform(a.data(), b.data(), false, 1);
+			for (size_t j = 0; j < l; ++j) b[j] = b[j] * h[j];
+			c.convolution->transform(b.data(), a.data(), true, 1);
+
+			for (size_t q = 0; q < p; ++q) out[u + q * m] = a[q] * (backward ? conj(c.w[q]) : c.w[q]);
+		}
+	}
+
+	size_t n;
+	unsigned threads;
+	std::vector<Complex<T>> tw_fwd;
+	std::vector<Complex<T>> tw_inv;
+	std::vector<size_t> factors;
+	std::map<size_t, Chirp> chirps;  // By prime factor above bluestein_threshold
+};
+
+//**********************************************************************************************************************
+
+template <typename T> void fft(Complex<T> const* in, Complex<T>* out, size_t n)
+{
+	FFTPlan<T>::get(n)->forward(in, out);
+}
+
+template <typename T> void ifft(Complex<T> const* in, Complex<T>* out, size_t n)
+{
+	FFTPlan<T>::get(n)->inverse(in, out);
+}
+
+//**********************************************************************************************************************
@@ -25,7 +25,11 @@ SOFTWARE.
 
 #pragma once
 
+#include "LookupTable.h"
+#include "Simd.h"
+
 #include <cmath>
+#include <cstddef>
 
 /***********************************************************************************************************************
 *** Template functions
@@ -58,7 +62,7 @@ template <typename T> T Minimum(T const& x, T const& y)
 
 template <typename T> T ReLU(T const& x)
 {
-	return Maximum(x, 0);
+	return Maximum(x, T(0));
 }
 
 template <typename T> T Restrict(T const& x, T const& a, T const& b)
@@ -72,3 +76,192 @@ template <typename T> T SoftPlus(T const& x)
 }
 
 //**********************************************************************************************************************
+
+/***********************************************************************************************************************
+*** Batch versions -- y[i] = f(x[i]) for i < n; 'y' may equal 'x' for in-place evaluation
+***********************************************************************************************************************/
+
+// Accuracy::Full evaluates Logistic and SoftPlus with the SimdMath exp and log1p, within 3 ulp of the exact result.
+// Accuracy::Fast uses a degree 5 exp polynomial and a 3 term log1p series: relative error below 4e-6 for Logistic and
+// below 6e-6 for SoftPlus.  CostW and InvAct round within a few ulp, like their scalar templates.  Maximum, Minimum,
+// ReLU and Restrict compare instead of using the arithmetic of their templates, so they are exact, and of a comparison
+// with NaN they give the second operand, like the hardware: ReLU and Restrict pass NaN on, Maximum(x, y) and Minimum(x,
+// y) give y if either is NaN.  Every element gets the same result whether it lands in a vector or in the scalar tail.
+
+enum class Accuracy { Full, Fast };
+
+template <typename T, typename V, typename F> void BatchApply(T const* x, T* y, size_t n, V const& vector, F const& scalar)
+{
+	typedef Simd<T> S;
+
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width) S::store(&y[i], vector(S::load(&x[i])));
+	for (; i < n; ++i) y[i] = scalar(x[i]);
+}
+
+//**********************************************************************************************************************
+
+template <typename T> void CostW(T const* x, T* y, size_t n)
+{
+	typedef Simd<T> S;
+
+	BatchApply(x, y, n, [](typename S::type const& r)
+	{
+		auto const r2 = S::mul(r, r);
+		auto const d = S::sub(r2, S::set1(T(1)));
+		return S::div(S::mul(d, d), S::add(r2, S::set1(T(1))));
+	}, [](T const& r) { return CostW(r); });
+}
+
+template <typename T> void InvAct(T const* x, T* y, size_t n)
+{
+	typedef Simd<T> S;
+
+	BatchApply(x, y, n, [](typename S::type const& r)
+	{
+		return S::sub(S::sqrt(S::fma(r, r, S::set1(T(1)))), S::mul(S::set1(T(1.41421356237309505)), r));
+	}, [](T const& r) { return InvAct(r); });
+}
+
+template <typename T> void Logistic(T const* x, T* y, size_t n, Accuracy mode = Accuracy::Full)
+{
+	typedef Simd<T> S;
+	typedef SimdMath<T> M;
+	typedef SimdConstants<T> K;
+
+	if constexpr (S::width > 1)
+	{
+		if (mode == Accuracy::Fast)
+		{
+			BatchApply(x, y, n, [](typename S::type const& r)
+			{
+				auto const e = M::template exp<K::exp_degree_fast>(S::mul(r, S::set1(T(-1))));
+				return S::div(S::set1(T(1)), S::add(S::set1(T(1)), e));
+			}, [](T const& r) { return Logistic(r); });
+		}
+		else
+		{
+			BatchApply(x, y, n, [](typename S::type const& r)
+			{
+				return S::div(S::set1(T(1)), S::add(S::set1(T(1)), M::exp(S::mul(r, S::set1(T(-1))))));
+			}, [](T const& r) { return Logistic(r); });
+		}
+	}
+	else for (size_t i = 0; i < n; ++i) y[i] = Logistic(x[i]);
+}
+
+template <typename T> void Maximum(T const* x, T const* y, T* z, size_t n)
+{
+	typedef Simd<T> S;
+
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width) S::store(&z[i], S::max(S::load(&x[i]), S::load(&y[i])));
+	for (; i < n; ++i) z[i] = x[i] > y[i] ? x[i] : y[i];
+}
+
+template <typename T> void Minimum(T const* x, T const* y, T* z, size_t n)
+{
+	typedef Simd<T> S;
+
+	size_t i = 0;
+
+	if constexpr (S::width > 1) for (; i + S::width <= n; i += S::width) S::store(&z[i], S::min(S::load(&x[i]), S::load(&y[i])));
+	for (; i < n; ++i) z[i] = x[i] < y[i] ? x[i] : y[i];
+}
+
+template <typename T> void ReLU(T const* x, T* y, size_t n)
+{
+	typedef Simd<T> S;
+
+	BatchApply(x, y, n, [](typename S::type const& r) { return S::max(S::set1(T()), r); }, [](T const& r) { return T() > r ? T() : r; });
+}
+
+template <typename T> void Restrict(T const* x, T* y, size_t n, T const& a, T const& b)
+{
+	typedef Simd<T> S;
+
+	T const lo = a < b ? a : b, hi = a < b ? b : a;
+
+	BatchApply(x, y, n, [=](typename S::type const& r)
+	{
+		return S::min(S::set1(hi), S::max(S::set1(lo), r));
+	}, [=](T const& r)
+	{
+		T const s = lo > r ? lo : r;
+		return hi < s ? hi : s;
+	});
+}
+
+template <typename T> void SoftPlus(T const* x, T* y, size_t n, Accuracy mode = Accuracy::Full)
+{
+	typedef Simd<T> S;
+	typedef SimdMath<T> M;
+	typedef SimdConstants<T> K;
+
+	auto const scalar = [](T const& r)  // max(x, 0) + log1p(exp(-|x|)) never overflows
+	{
+		using std::abs; using std::exp; using std::log1p;
+		return (r < 0 ? T() : r) + log1p(exp(-abs(r)));
+	};
+
+	if constexpr (S::width > 1)
+	{
+		if (mode == Accuracy::Fast)
+		{
+			BatchApply(x, y, n, [](typename S::type const& r)
+			{
+				auto const e = M::template exp<K::exp_degree_fast>(S::mul(S::abs(r), S::set1(T(-1))));
+				return S::add(S::max(r, S::set1(T())), M::template log1p<K::log_degree_fast>(e));
+			}, scalar);
+		}
+		else
+		{
+			BatchApply(x, y, n, [](typename S::type const& r)
+			{
+				return S::add(S::max(r, S::set1(T())), M::log1p(M::exp(S::mul(S::abs(r), S::set1(T(-1))))));
+			}, scalar);
+		}
+	}
+	else for (size_t i = 0; i < n; ++i) y[i] = scalar(x[i]);
+}
+
+//**********************************************************************************************************************
+
+/***********************************************************************************************************************
+*** Table driven versions -- e.g. LogisticTable<1024, 3, float>::evaluate(x); see LookupTable.h for max_error
+***********************************************************************************************************************/
+
+struct LogisticCurve final
+{
+	static constexpr double range = 20;
+	static constexpr double bound1 = 0.25;
+	static constexpr double bound2 = 0.0962251;  // 1 / (6 sqrt(3))
+	static constexpr double bound4 = 0.127684;
+	static constexpr double peak = 1;
+
+	static constexpr double f(double x) { return 1 / (1 + const_exp(-x)); }
+	static constexpr double df(double x) { return f(x) * (1 - f(x)); }
+	static constexpr double below(double) { return 0; }
+	static constexpr double above(double) { return 1; }
+};
+
+struct SoftPlusCurve final
+{
+	static constexpr double range = 20;
+	static constexpr double bound1 = 1;
+	static constexpr double bound2 = 0.25;
+	static constexpr double bound4 = 0.125;
+	static constexpr double peak = 20;
+
+	static constexpr double f(double x) { return const_log1p(const_exp(x)); }
+	static constexpr double df(double x) { return LogisticCurve::f(x); }
+	static constexpr double below(double) { return 0; }
+	static constexpr double above(double x) { return x; }
+};
+
+template <size_t Size, int Order = 1, typename T = double> using LogisticTable = LookupTable<LogisticCurve, Size, Order, T>;
+template <size_t Size, int Order = 1, typename T = double> using SoftPlusTable = LookupTable<SoftPlusCurve, Size, Order, T>;
+
+//**********************************************************************************************************************
@@ -36,13 +36,10 @@ SOFTWARE.
 
 template <typename T> struct Location final
 {
-	Location() : x(0), y(0), z(0) { }
-	Location(Location const& r) : x(r.x), y(r.y), z(r.z) { }
-	Location(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
+	constexpr Location() : x(0), y(0), z(0) { }
+	constexpr Location(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
 
-	Location& operator=(Location const& r) { x = r.x; y = r.y; z = r.z; return *this; }
-
-	template <typename U> operator Location<U>() const { return { U(x), U(y), U(z) }; }
+	template <typename U> constexpr operator Location<U>() const { return { U(x), U(y), U(z) }; }
 
 	T x, y, z;
 };
@@ -53,13 +50,10 @@ template <typename T> struct Location final
 
 template <typename T> struct Orientation final
 {
-	Orientation() : w(1), x(0), y(0), z(0) { }
-	Orientation(Orientation const& r) : w(r.w), x(r.x), y(r.y), z(r.z) { }
-	Orientation(T const& w, T const& x, T const& y, T const& z) : w(w), x(x), y(y), z(z) { }
-
-	Orientation& operator=(Orientation const& r) { w = r.w; x = r.x; y = r.y; z = r.z; return *this; }
+	constexpr Orientation() : w(1), x(0), y(0), z(0) { }
+	constexpr Orientation(T const& w, T const& x, T const& y, T const& z) : w(w), x(x), y(y), z(z) { }
 
-	template <typename U> operator Orientation<U>() const { return { U(w), U(x), U(y), U(z) }; }
+	template <typename U> constexpr operator Orientation<U>() const { return { U(w), U(x), U(y), U(z) }; }
 
 	T w, x, y, z;
 };
@@ -70,13 +64,10 @@ template <typename T> struct Orientation final
 
 template <typename T> struct Rotation final
 {
-	Rotation() : w(1), x(0), y(0), z(0) { }
-	Rotation(Rotation const& r) : w(r.w), x(r.x), y(r.y), z(r.z) { }
-	Rotation(T const& w, T const& x, T const& y, T const& z) : w(w), x(x), y(y), z(z) { }
+	constexpr Rotation() : w(1), x(0), y(0), z(0) { }
+	constexpr Rotation(T const& w, T const& x, T const& y, T const& z) : w(w), x(x), y(y), z(z) { }
 
-	Rotation& operator=(Rotation const& r) { w = r.w; x = r.x; y = r.y; z = r.z; return *this; }
-
-	template <typename U> operator Rotation<U>() const { return { U(w), U(x), U(y), U(z) }; }
+	template <typename U> constexpr operator Rotation<U>() const { return { U(w), U(x), U(y), U(z) }; }
 
 	Orientation<T> operator()(Orientation<T> const&) const;
 	Rotation<T> operator()(Rotation<T> const&) const;
@@ -90,16 +81,13 @@ template <typename T> struct Rotation final
 
 template <typename T> struct Translation final
 {
-	Translation() : x(0), y(0), z(0) { }
-	Translation(Translation const& r) : x(r.x), y(r.y), z(r.z) { }
-	Translation(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
-
-	Translation& operator=(Translation const& r) { x = r.x; y = r.y; z = r.z; return *this; }
+	constexpr Translation() : x(0), y(0), z(0) { }
+	constexpr Translation(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
 
-	template <typename U> operator Translation<U>() const { return { U(x), U(y), U(z) }; }
+	template <typename U> constexpr operator Translation<U>() const { return { U(x), U(y), U(z) }; }
 
-	Location<T> operator()(Location<T> const& r) const;
-	Translation<T> operator()(Translation<T> const& r) const;
+	constexpr Location<T> operator()(Location<T> const& r) const;
+	constexpr Translation<T> operator()(Translation<T> const& r) const;
 
 	T x, y, z;
 };
@@ -116,11 +104,11 @@ template <typename T> struct Pose final
 
 //**********************************************************************************************************************
 
-template <typename T> Location<T> Translation<T>::operator()(Location<T> const& r) const { return { r.x + x, r.y + y, r.z + z }; }
-template <typename T> Translation<T> Translation<T>::operator()(Translation<T> const& r) const { return { x + r.x, y + r.y, z + r.z }; }
+template <typename T> constexpr Location<T> Translation<T>::operator()(Location<T> const& r) const { return { r.x + x, r.y + y, r.z + z }; }
+template <typename T> constexpr Translation<T> Translation<T>::operator()(Translation<T> const& r) const { return { x + r.x, y + r.y, z + r.z }; }
 
-template <typename T> Location<T> operator+(Location<T> const& r, Translation<T> const& s) { return { r.x + s.x, r.y + s.y, r.z + s.z }; }
-template <typename T> Translation<T> operator-(Location<T> const& r, Location<T> const& s) { return { r.x - s.x, r.y - s.y, r.z - s.z }; }
+template <typename T> constexpr Location<T> operator+(Location<T> const& r, Translation<T> const& s) { return { r.x + s.x, r.y + s.y, r.z + s.z }; }
+template <typename T> constexpr Translation<T> operator-(Location<T> const& r, Location<T> const& s) { return { r.x - s.x, r.y - s.y, r.z - s.z }; }
 
 /***********************************************************************************************************************
 *** Vector -- position or translation in 3D space
@@ -128,13 +116,13 @@ template <typename T> Translation<T> operator-(Location<T> const& r, Location<T>
 
 template<typename T> struct Vector final
 {
-	Vector() : x(T()), y(T()), z(T()) { }
+	constexpr Vector() : x(T()), y(T()), z(T()) { }
 
-	template <typename U> Vector(Vector<U> const& r) : x(T(r.x)), y(T(r.y)), z(T(r.z)) { }
+	template <typename U> constexpr Vector(Vector<U> const& r) : x(T(r.x)), y(T(r.y)), z(T(r.z)) { }
 
-	Vector(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
+	constexpr Vector(T const& x, T const& y, T const& z) : x(x), y(y), z(z) { }
 
-	template <typename U> Vector& operator=(Vector<U> const& r)
+	template <typename U> constexpr Vector& operator=(Vector<U> const& r)
 	{
 		x = T(r.x);
 		y = T(r.y);
@@ -148,13 +136,13 @@ template<typename T> struct Vector final
 
 //**********************************************************************************************************************
 
-template <typename T> Vector<T> operator+(Vector<T> const& r) { return { +r.x, +r.y, +r.z }; }
-template <typename T> Vector<T> operator-(Vector<T> const& r) { return { -r.x, -r.y, -r.z }; }
-template <typename T> Vector<T> operator+(Vector<T> const& r, Vector<T> const& s) { return { r.x + s.x, r.y + s.y, r.z + s.z }; }
-template <typename T> Vector<T> operator-(Vector<T> const& r, Vector<T> const& s) { return { r.x - s.x, r.y - s.y, r.z - s.z }; }
-template <typename T> Vector<T> operator*(T const& r, Vector<T> const& s) { return { r * s.x, r * s.y, r * s.z }; }
-template <typename T> Vector<T> operator*(Vector<T> const& r, T const& s) { return { r.x * s, r.y * s, r.z * s }; }
-template <typename T> Vector<T> operator/(Vector<T> const& r, T const& s) { return { r.x / s, r.y / s, r.z / s }; }
+template <typename T> constexpr Vector<T> operator+(Vector<T> const& r) { return { +r.x, +r.y, +r.z }; }
+template <typename T> constexpr Vector<T> operator-(Vector<T> const& r) { return { -r.x, -r.y, -r.z }; }
+template <typename T> constexpr Vector<T> operator+(Vector<T> const& r, Vector<T> const& s) { return { r.x + s.x, r.y + s.y, r.z + s.z }; }
+template <typename T> constexpr Vector<T> operator-(Vector<T> const& r, Vector<T> const& s) { return { r.x - s.x, r.y - s.y, r.z - s.z }; }
+template <typename T> constexpr Vector<T> operator*(T const& r, Vector<T> const& s) { return { r * s.x, r * s.y, r * s.z }; }
+template <typename T> constexpr Vector<T> operator*(Vector<T> const& r, T const& s) { return { r.x * s, r.y * s, r.z * s }; }
+template <typename T> constexpr Vector<T> operator/(Vector<T> const& r, T const& s) { return { r.x / s, r.y / s, r.z / s }; }
 
 template <typename T> T abs(Vector<T> const& r) { return sqrt(r.x * r.x + r.y * r.y + r.z * r.z); }
 template <typename T> Vector<T> normalize(Vector<T> const& r) { return r / abs(r); }
@@ -167,15 +155,15 @@ template <typename T> std::ostream& operator<<(std::ostream& out, Vector<T> cons
 
 template<typename T> struct Quaternion final
 {
-	Quaternion() : w(T()), x(T()), y(T()), z(T()) { }
+	constexpr Quaternion() : w(T()), x(T()), y(T()), z(T()) { }
 
-	template <typename U> Quaternion(Quaternion<U> const& r) : w(T(r.w)), x(T(r.x)), y(T(r.y)), z(T(r.z)) { }
+	template <typename U> constexpr Quaternion(Quaternion<U> const& r) : w(T(r.w)), x(T(r.x)), y(T(r.y)), z(T(r.z)) { }
 
-	Quaternion(T const& r, T const& s, T const& t, T const& u) : w(r), x(s), y(t), z(u) { }
+	constexpr Quaternion(T const& r, T const& s, T const& t, T const& u) : w(r), x(s), y(t), z(u) { }
 
-	Quaternion(T const& r, Vector<T> const& s) : w(r), x(s.x), y(s.y), z(s.z) { }
+	constexpr Quaternion(T const& r, Vector<T> const& s) : w(r), x(s.x), y(s.y), z(s.z) { }
 
-	template <typename U> Quaternion& operator=(Quaternion<U> const& r)
+	template <typename U> constexpr Quaternion& operator=(Quaternion<U> const& r)
 	{
 		w = T(r.w);
 		x = T(r.x);
@@ -185,7 +173,7 @@ template<typename T> struct Quaternion final
 		return *this;
 	}
 
-	Vector<T> operator()(Vector<T> const& r) const
+	constexpr Vector<T> operator()(Vector<T> const& r) const
 	{
 		auto ww = w * w;
 		auto wx = w * x;
@@ -206,12 +194,12 @@ template<typename T> struct Quaternion final
 		};
 	}
 
-	T scalar() const
+	constexpr T scalar() const
 	{
 		return w;
 	}
 
-	Vector<T> vector() const
+	constexpr Vector<T> vector() const
 	{
 		return { x, y, z };
 	}
@@ -221,7 +209,7 @@ template<typename T> struct Quaternion final
 
 //**********************************************************************************************************************
 
-template <typename T> Quaternion<T> operator*(Quaternion<T> const& r, Quaternion<T> const& s)
+template <typename T> constexpr Quaternion<T> operator*(Quaternion<T> const& r, Quaternion<T> const& s)
 {
 	return 
 	{
@@ -230,16 +218,16 @@ template <typename T> Quaternion<T> operator*(Quaternion<T> const& r, Quaternion
 	};
 }
 
-template <typename T> Quaternion<T> operator*(T const& r, Quaternion<T> const& s) { return { r * s.w, r * s.x, r * s.y, r * s.z }; }
-template <typename T> Quaternion<T> operator*(Quaternion<T> const& r, T const& s) { return { r.w * s, r.x * s, r.y * s, r.z * s }; }
-template <typename T> Quaternion<T> operator/(Quaternion<T> const& r, T const& s) { return { r.w / s, r.x / s, r.y / s, r.z / s }; }
+template <typename T> constexpr Quaternion<T> operator*(T const& r, Quaternion<T> const& s) { return { r * s.w, r * s.x, r * s.y, r * s.z }; }
+template <typename T> constexpr Quaternion<T> operator*(Quaternion<T> const& r, T const& s) { return { r.w * s, r.x * s, r.y * s, r.z * s }; }
+template <typename T> constexpr Quaternion<T> operator/(Quaternion<T> const& r, T const& s) { return { r.w / s, r.x / s, r.y / s, r.z / s }; }
 
 template <typename T> T abs(Quaternion<T> const& r)
 {
 	return sqrt(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
 }
 
-template <typename T> Quaternion<T> conjugate(Quaternion<T> const& r)
+template <typename T> constexpr Quaternion<T> conjugate(Quaternion<T> const& r)
 {
 	return { r.w, -r.x, -r.y, -r.z };
 }
@@ -249,7 +237,7 @@ template <typename T> Quaternion<T> exp(Quaternion<T> const& r)
 	return exp(r.scalar()) * Quaternion<T>(cos(abs(r.vector())), normalize(r.vector()) * sin(abs(r.vector())));
 }
 
-template <typename T> Quaternion<T> inverse(Quaternion<T> const& r)
+template <typename T> constexpr Quaternion<T> inverse(Quaternion<T> const& r)
 {
 	return conjugate(r) / (r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
 }
@@ -286,3 +274,16 @@ template <typename T> std::ostream& operator<<(std::ostream& out, Quaternion<T>
 /* TODO:  Euler to Quaternion conversions */
 
 //**********************************************************************************************************************
+
+static_assert(std::is_trivially_copyable_v<Location<double>> && std::is_standard_layout_v<Location<double>>);
+static_assert(std::is_trivially_copyable_v<Orientation<double>> && std::is_standard_layout_v<Orientation<double>>);
+static_assert(std::is_trivially_copyable_v<Rotation<double>> && std::is_standard_layout_v<Rotation<double>>);
+static_assert(std::is_trivially_copyable_v<Translation<double>> && std::is_standard_layout_v<Translation<double>>);
+static_assert(std::is_trivially_copyable_v<Pose<double>> && std::is_standard_layout_v<Pose<double>>);
+static_assert(std::is_trivially_copyable_v<Vector<double>> && std::is_standard_layout_v<Vector<double>>);
+static_assert(std::is_trivially_copyable_v<Quaternion<double>> && std::is_standard_layout_v<Quaternion<double>>);
+
+static_assert(Translation<double>(1, 2, 3)(Location<double>(1, 1, 1)).z == 4);
+static_assert(Quaternion<double>(0, 0, 0, 1)(Vector<double>(1, 0, 0)).x == -1);
+
+//**********************************************************************************************************************
@@ -0,0 +1,137 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+/***********************************************************************************************************************
+*** Compile time elementary functions (accurate to a few ulp; used to fill the tables below)
+***********************************************************************************************************************/
+
+constexpr double const_exp(double x)
+{
+	long long k = (long long)(x * 1.44269504088896340736 + (x < 0 ? -0.5 : 0.5));
+	double const r = x - k * 6.93147180369123816490e-01 - k * 1.90821492927058770002e-10;
+	double term = 1, sum = 1;
+
+	for (int n = 1; n < 20; ++n) sum += term *= r / n;
+	for (; k > 0; --k) sum *= 2;
+	for (; k < 0; ++k) sum /= 2;
+	return sum;
+}
+
+constexpr double const_log1p(double x)  // x > -1
+{
+	double m = 1 + x, s = x / (2 + x);
+	int k = 0;
+
+	if (m > 1.41421356237309505 || m < 0.70710678118654752)
+	{
+		for (; m > 1.41421356237309505; ++k) m /= 2;
+		for (; m < 0.70710678118654752; --k) m *= 2;
+		s = (m - 1) / (m + 1);
+	}
+
+	double sum = 0, term = s;
+
+	for (int n = 1; n < 40; n += 2, term *= s * s) sum += term / n;
+	return 2 * sum + k * 0.693147180559945309417;
+}
+
+/***********************************************************************************************************************
+*** LookupTable -- uniformly sampled f on [-range, range] with linear (Order 1) or cubic Hermite (Order 3) interpolation
+***********************************************************************************************************************/
+
+// 'Curve' supplies constexpr f and df, bounds for max|f'|, max|f''| and max|f''''| on the range, peak >= max|f| on the
+// range, and the values used beyond either end, which must be within exp(-range) of f.  The table is built entirely at
+// compile time; max_error is the resulting absolute error bound: interpolation remainder, tail, rounding of the stored
+// values and of the arithmetic, and the rounding of the node position (x - lo) / step times the slope.
+
+template <typename Curve, size_t Size, int Order = 1, typename T = double> struct LookupTable final
+{
+	static_assert(Size >= 2, "LookupTable needs at least two nodes");
+	static_assert(Order == 1 || Order == 3, "LookupTable interpolates linearly (1) or with cubic Hermite splines (3)");
+
+	static constexpr double lo = -Curve::range;
+	static constexpr double hi = Curve::range;
+	static constexpr double step = (hi - lo) / (Size - 1);
+
+	static constexpr double max_error = (Order == 1 ? step * step / 8 * Curve::bound2 : step * step * step * step / 384 * Curve::bound4)
+		+ const_exp(-Curve::range) + 4 * std::numeric_limits<T>::epsilon() * (Curve::peak + Curve::range * Curve::bound1);
+
+	static T evaluate(T const& x) noexcept
+	{
+		if (x < T(lo)) return T(Curve::below(x));
+		if (x >= T(hi)) return T(Curve::above(x));
+		if (x != x) return x;  // NaN
+
+		T const u = (x - T(lo)) * T(1 / step);
+		size_t i = size_t(u);
+		if (i > Size - 2) i = Size - 2;
+		T const t = u - T(i);
+
+		if constexpr (Order == 1)
+		{
+			return table[i] + t * (table[i + 1] - table[i]);
+		}
+		else
+		{
+			T const v0 = table[2 * i], m0 = table[2 * i + 1], v1 = table[2 * i + 2], m1 = table[2 * i + 3];
+			return v0 + t * (m0 + t * (3 * (v1 - v0) - 2 * m0 - m1 + t * (2 * (v0 - v1) + m0 + m1)));
+		}
+	}
+
+private:
+	typedef std::array<T, Order == 1 ? Size : 2 * Size> Nodes;  // Values, or value and slope pairs
+
+	static constexpr Nodes build()
+	{
+		Nodes result{};
+
+		for (size_t i = 0; i < Size; ++i)
+		{
+			double const x = lo + i * step;
+
+			if constexpr (Order == 1)
+			{
+				result[i] = T(Curve::f(x));
+			}
+			else
+			{
+				result[2 * i] = T(Curve::f(x));
+				result[2 * i + 1] = T(Curve::df(x) * step);  // Slope per node interval
+			}
+		}
+		return result;
+	}
+
+	static constexpr Nodes table = build();
+};
+
+//**********************************************************************************************************************
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #pragma once
 
+#include "LookupTable.h"
+
 #include <assert.h>
 #include <cmath>
 
@@ -34,19 +36,17 @@ SOFTWARE.
 *** Helper functions:
 ***********************************************************************************************************************/
 
-static double const PiPiDiv6 = 1.64493406684822644e-00;
+static constexpr double PiPiDiv6 = 1.64493406684822644e-00;
 
-static inline double sq(double x)
+static constexpr double sq(double x)
 {
     return x * x;
 }
 
-static inline double bernoulli(double x)
+static constexpr double bernoulli_series(double x)
 {
-    assert(abs(x) <= log(2));
-
     double const x2 = x * x;
-    double power[8];
+    double power[8] = {};
 
     power[0] = x2 * x;
     power[1] = x2 * power[0];
@@ -57,7 +57,7 @@ static inline double bernoulli(double x)
     power[6] = x2 * power[5];
     power[7] = x2 * power[6];
 
-    double total;
+    double total = 0;
 
     total = -power[7] * 1.99392958607210757e-14;
     total += power[6] * 8.92169102045645256e-13;
@@ -71,6 +71,13 @@ static inline double bernoulli(double x)
     return total + x - x2 / 4;
 }
 
+static inline double bernoulli(double x)
+{
+    assert(abs(x) <= log(2));
+
+    return bernoulli_series(x);
+}
+
 /***********************************************************************************************************************
 *** Polylog2
 ***********************************************************************************************************************/
@@ -95,3 +102,34 @@ inline double Spp(double x)
 }
 
 //**********************************************************************************************************************
+
+/***********************************************************************************************************************
+*** Table driven Spp -- e.g. SppTable<1024, 3>::evaluate(x); see LookupTable.h for max_error
+***********************************************************************************************************************/
+
+struct SppCurve final
+{
+    static constexpr double range = 20;
+    static constexpr double bound1 = 20 + 2.07e-9;  // Spp' is SoftPlus
+    static constexpr double bound2 = 1;  // Spp'' is Logistic
+    static constexpr double bound4 = 0.0962251;
+    static constexpr double peak = 20 * 20 / 2 + PiPiDiv6;
+
+    static constexpr double f(double x)
+    {
+        if (x <= 0) return -bernoulli_series(-const_log1p(const_exp(x)));
+        return bernoulli_series(-const_log1p(const_exp(-x))) + PiPiDiv6 + sq(x) / 2;
+    }
+
+    static constexpr double df(double x)  // SoftPlus
+    {
+        return x <= 0 ? const_log1p(const_exp(x)) : x + const_log1p(const_exp(-x));
+    }
+
+    static constexpr double below(double) { return 0; }
+    static constexpr double above(double x) { return PiPiDiv6 + sq(x) / 2; }
+};
+
+template <size_t Size, int Order = 1, typename T = double> using SppTable = LookupTable<SppCurve, Size, Order, T>;
+
+//**********************************************************************************************************************
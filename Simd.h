@@ -0,0 +1,360 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/***********************************************************************************************************************
+*** Simd -- thin wrapper over the widest vector registers enabled at compile time (scalar fallback for any other T)
+***********************************************************************************************************************/
+
+template <typename T> struct Simd final
+{
+	typedef T type;
+	typedef bool mask;
+
+	static size_t const width = 1;
+
+	static type load(T const* p) { return *p; }
+	static void store(T* p, type const& r) { *p = r; }
+	static type set1(T const& r) { return r; }
+
+	static type add(type const& r, type const& s) { return r + s; }
+	static type sub(type const& r, type const& s) { return r - s; }
+	static type mul(type const& r, type const& s) { return r * s; }
+	static type div(type const& r, type const& s) { return r / s; }
+	static type fma(type const& r, type const& s, type const& t) { return r * s + t; }  // r * s + t
+	static type min(type const& r, type const& s) { return r < s ? r : s; }  // Like the hardware, 's' if either is NaN
+	static type max(type const& r, type const& s) { return s < r ? r : s; }
+	static type sqrt(type const& r) { using std::sqrt; return sqrt(r); }
+	static type abs(type const& r) { using std::abs; return abs(r); }
+	static type floor(type const& r) { using std::floor; return floor(r); }
+	static type round(type const& r) { using std::nearbyint; return nearbyint(r); }  // To nearest even
+	static type scale(type const& r, type const& s) { using std::ldexp; return ldexp(r, int(s)); }  // r * 2^s, integral s
+
+	static mask less(type const& r, type const& s) { return r < s; }
+	static type select(mask const& m, type const& r, type const& s) { return m ? r : s; }
+	static bool any(mask const& m) { return m; }
+	static unsigned bits(mask const& m) { return m; }  // Bit 'i' set for lane 'i'
+};
+
+#if defined(__AVX512F__)
+
+template <> struct Simd<double> final
+{
+	typedef __m512d type;
+	typedef __mmask8 mask;
+
+	static size_t const width = 8;
+
+	static type load(double const* p) { return _mm512_loadu_pd(p); }
+	static void store(double* p, type const& r) { _mm512_storeu_pd(p, r); }
+	static type set1(double const& r) { return _mm512_set1_pd(r); }
+
+	static type add(type const& r, type const& s) { return _mm512_add_pd(r, s); }
+	static type sub(type const& r, type const& s) { return _mm512_sub_pd(r, s); }
+	static type mul(type const& r, type const& s) { return _mm512_mul_pd(r, s); }
+	static type div(type const& r, type const& s) { return _mm512_div_pd(r, s); }
+	static type fma(type const& r, type const& s, type const& t) { return _mm512_fmadd_pd(r, s, t); }
+	static type min(type const& r, type const& s) { return _mm512_min_pd(r, s); }
+	static type max(type const& r, type const& s) { return _mm512_max_pd(r, s); }
+	static type sqrt(type const& r) { return _mm512_sqrt_pd(r); }
+	static type abs(type const& r) { return _mm512_abs_pd(r); }
+	static type floor(type const& r) { return _mm512_roundscale_pd(r, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	static type round(type const& r) { return _mm512_roundscale_pd(r, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static type scale(type const& r, type const& s) { return _mm512_scalef_pd(r, s); }
+
+	static mask less(type const& r, type const& s) { return _mm512_cmp_pd_mask(r, s, _CMP_LT_OQ); }
+	static type select(mask const& m, type const& r, type const& s) { return _mm512_mask_blend_pd(m, s, r); }
+	static bool any(mask const& m) { return m != 0; }
+	static unsigned bits(mask const& m) { return m; }
+};
+
+template <> struct Simd<float> final
+{
+	typedef __m512 type;
+	typedef __mmask16 mask;
+
+	static size_t const width = 16;
+
+	static type load(float const* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, type const& r) { _mm512_storeu_ps(p, r); }
+	static type set1(float const& r) { return _mm512_set1_ps(r); }
+
+	static type add(type const& r, type const& s) { return _mm512_add_ps(r, s); }
+	static type sub(type const& r, type const& s) { return _mm512_sub_ps(r, s); }
+	static type mul(type const& r, type const& s) { return _mm512_mul_ps(r, s); }
+	static type div(type const& r, type const& s) { return _mm512_div_ps(r, s); }
+	static type fma(type const& r, type const& s, type const& t) { return _mm512_fmadd_ps(r, s, t); }
+	static type min(type const& r, type const& s) { return _mm512_min_ps(r, s); }
+	static type max(type const& r, type const& s) { return _mm512_max_ps(r, s); }
+	static type sqrt(type const& r) { return _mm512_sqrt_ps(r); }
+	static type abs(type const& r) { return _mm512_abs_ps(r); }
+	static type floor(type const& r) { return _mm512_roundscale_ps(r, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	static type round(type const& r) { return _mm512_roundscale_ps(r, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static type scale(type const& r, type const& s) { return _mm512_scalef_ps(r, s); }
+
+	static mask less(type const& r, type const& s) { return _mm512_cmp_ps_mask(r, s, _CMP_LT_OQ); }
+	static type select(mask const& m, type const& r, type const& s) { return _mm512_mask_blend_ps(m, s, r); }
+	static bool any(mask const& m) { return m != 0; }
+	static unsigned bits(mask const& m) { return m; }
+};
+
+#elif defined(__AVX2__)
+
+template <> struct Simd<double> final
+{
+	typedef __m256d type;
+	typedef __m256d mask;
+
+	static size_t const width = 4;
+
+	static type load(double const* p) { return _mm256_loadu_pd(p); }
+	static void store(double* p, type const& r) { _mm256_storeu_pd(p, r); }
+	static type set1(double const& r) { return _mm256_set1_pd(r); }
+
+	static type add(type const& r, type const& s) { return _mm256_add_pd(r, s); }
+	static type sub(type const& r, type const& s) { return _mm256_sub_pd(r, s); }
+	static type mul(type const& r, type const& s) { return _mm256_mul_pd(r, s); }
+	static type div(type const& r, type const& s) { return _mm256_div_pd(r, s); }
+#if defined(__FMA__)
+	static type fma(type const& r, type const& s, type const& t) { return _mm256_fmadd_pd(r, s, t); }
+#else
+	static type fma(type const& r, type const& s, type const& t) { return _mm256_add_pd(_mm256_mul_pd(r, s), t); }
+#endif
+	static type min(type const& r, type const& s) { return _mm256_min_pd(r, s); }
+	static type max(type const& r, type const& s) { return _mm256_max_pd(r, s); }
+	static type sqrt(type const& r) { return _mm256_sqrt_pd(r); }
+	static type abs(type const& r) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), r); }
+	static type floor(type const& r) { return _mm256_round_pd(r, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	static type round(type const& r) { return _mm256_round_pd(r, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+	static type scale(type const& r, type const& s)  // |s| <= 1022
+	{
+		__m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(s));
+		return _mm256_mul_pd(r, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52)));
+	}
+
+	static mask less(type const& r, type const& s) { return _mm256_cmp_pd(r, s, _CMP_LT_OQ); }
+	static type select(mask const& m, type const& r, type const& s) { return _mm256_blendv_pd(s, r, m); }
+	static bool any(mask const& m) { return _mm256_movemask_pd(m) != 0; }
+	static unsigned bits(mask const& m) { return unsigned(_mm256_movemask_pd(m)); }
+};
+
+template <> struct Simd<float> final
+{
+	typedef __m256 type;
+	typedef __m256 mask;
+
+	static size_t const width = 8;
+
+	static type load(float const* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, type const& r) { _mm256_storeu_ps(p, r); }
+	static type set1(float const& r) { return _mm256_set1_ps(r); }
+
+	static type add(type const& r, type const& s) { return _mm256_add_ps(r, s); }
+	static type sub(type const& r, type const& s) { return _mm256_sub_ps(r, s); }
+	static type mul(type const& r, type const& s) { return _mm256_mul_ps(r, s); }
+	static type div(type const& r, type const& s) { return _mm256_div_ps(r, s); }
+#if defined(__FMA__)
+	static type fma(type const& r, type const& s, type const& t) { return _mm256_fmadd_ps(r, s, t); }
+#else
+	static type fma(type const& r, type const& s, type const& t) { return _mm256_add_ps(_mm256_mul_ps(r, s), t); }
+#endif
+	static type min(type const& r, type const& s) { return _mm256_min_ps(r, s); }
+	static type max(type const& r, type const& s) { return _mm256_max_ps(r, s); }
+	static type sqrt(type const& r) { return _mm256_sqrt_ps(r); }
+	static type abs(type const& r) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), r); }
+	static type floor(type const& r) { return _mm256_round_ps(r, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	static type round(type const& r) { return _mm256_round_ps(r, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+	static type scale(type const& r, type const& s)  // |s| <= 126
+	{
+		__m256i e = _mm256_cvtps_epi32(s);
+		return _mm256_mul_ps(r, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(127)), 23)));
+	}
+
+	static mask less(type const& r, type const& s) { return _mm256_cmp_ps(r, s, _CMP_LT_OQ); }
+	static type select(mask const& m, type const& r, type const& s) { return _mm256_blendv_ps(s, r, m); }
+	static bool any(mask const& m) { return _mm256_movemask_ps(m) != 0; }
+	static unsigned bits(mask const& m) { return unsigned(_mm256_movemask_ps(m)); }
+};
+
+#endif
+
+/***********************************************************************************************************************
+*** SimdMath -- vectorized exp, log1p, sin/cos and sinh/cosh built on Simd<T>; within a few ulp of libm
+***********************************************************************************************************************/
+
+// Cody-Waite argument reduction followed by truncated Taylor series; the constants below are per precision.
+
+template <typename T> struct SimdConstants;
+
+template <> struct SimdConstants<double> final
+{
+	static int const exp_degree = 12;
+	static int const exp_degree_fast = 5;
+	static int const log_degree = 10;  // In s^2 of log1p(x) = 2 atanh(s)
+	static int const log_degree_fast = 2;
+	static int const sin_degree = 7;  // In r^2: sin up to r^15, cos up to r^16
+	static constexpr double exp_limit = 1400;
+	static constexpr double ln2_hi = 6.93147180369123816490e-01;
+	static constexpr double ln2_lo = 1.90821492927058770002e-10;
+	static constexpr double sincos_limit = 1e6;
+	static constexpr double pio2_1 = 1.57079632673412561417e+00;
+	static constexpr double pio2_2 = 6.07710050630396597660e-11;
+	static constexpr double pio2_3 = 2.02226624879595063154e-21;
+};
+
+template <> struct SimdConstants<float> final
+{
+	static int const exp_degree = 7;
+	static int const exp_degree_fast = 5;
+	static int const log_degree = 4;
+	static int const log_degree_fast = 2;
+	static int const sin_degree = 5;
+	static constexpr float exp_limit = 150;
+	static constexpr float ln2_hi = 0.693359375f;
+	static constexpr float ln2_lo = -2.12194440e-4f;
+	static constexpr float sincos_limit = 8192;
+	static constexpr float pio2_1 = 1.5703125f;
+	static constexpr float pio2_2 = 4.837512969970703125e-4f;
+	static constexpr float pio2_3 = 7.54978995489188216e-8f;
+};
+
+//**********************************************************************************************************************
+
+template <typename T> struct SimdMath final
+{
+	typedef Simd<T> S;
+	typedef SimdConstants<T> K;
+	typedef typename S::type type;
+
+	static T factorial_inverse(int k)
+	{
+		static double const table[] =
+		{
+			1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320, 1.0 / 362880,
+			1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800, 1.0 / 87178291200,
+			1.0 / 1307674368000, 1.0 / 20922789888000, 1.0 / 355687428096000
+		};
+		return T(table[k]);
+	}
+
+	template <int Degree = K::exp_degree> static type exp(type x)
+	{
+		x = S::min(S::set1(K::exp_limit), S::max(S::set1(-K::exp_limit), x));  // Operand order keeps NaN
+
+		type n = S::round(S::mul(x, S::set1(T(1.44269504088896340736))));
+		type r = S::fma(n, S::set1(-K::ln2_lo), S::fma(n, S::set1(-K::ln2_hi), x));
+		type p = S::set1(factorial_inverse(Degree));
+
+		for (int k = Degree - 1; k >= 0; --k) p = S::fma(p, r, S::set1(factorial_inverse(k)));
+
+		type half = S::floor(S::mul(n, S::set1(T(0.5))));  // Two steps keep each power of two representable
+		return S::scale(S::scale(p, half), S::sub(n, half));
+	}
+
+	template <int Degree = K::log_degree> static type log1p(type x)  // 0 <= x <= 1 only
+	{
+		auto upper = S::less(S::set1(T(0.414213562373095049)), x);  // log1p(x) = ln2 + log1p((x - 1) / 2) above sqrt2 - 1
+		type s = S::select(upper, S::div(S::sub(x, S::set1(T(1))), S::add(x, S::set1(T(3)))), S::div(x, S::add(x, S::set1(T(2)))));
+		type s2 = S::mul(s, s);
+		type p = S::set1(T(1) / T(2 * Degree + 1));
+
+		for (int k = Degree - 1; k >= 0; --k) p = S::fma(p, s2, S::set1(T(1) / T(2 * k + 1)));
+
+		type r = S::mul(S::mul(p, s), S::set1(T(2)));  // 2 atanh(s) = log((1 + s) / (1 - s))
+		return S::select(upper, S::add(r, S::set1(T(0.693147180559945309))), r);
+	}
+
+	static void sincos(type x, type& s, type& c)
+	{
+		if (S::any(S::less(S::set1(K::sincos_limit), S::abs(x))))  // Too large for the reduction; defer to libm
+		{
+			T a[S::width], b[S::width], d[S::width];
+
+			S::store(a, x);
+			for (size_t i = 0; i < S::width; ++i)
+			{
+				using std::sin; using std::cos;
+				b[i] = sin(a[i]);
+				d[i] = cos(a[i]);
+			}
+			s = S::load(b);
+			c = S::load(d);
+			return;
+		}
+
+		type q = S::round(S::mul(x, S::set1(T(0.636619772367581343076))));
+		type r = S::fma(q, S::set1(-K::pio2_3), S::fma(q, S::set1(-K::pio2_2), S::fma(q, S::set1(-K::pio2_1), x)));
+		type u = S::mul(S::mul(r, r), S::set1(T(-1)));
+		type ps = S::set1(factorial_inverse(2 * K::sin_degree + 1));
+		type pc = S::set1(factorial_inverse(2 * K::sin_degree + 2));
+
+		for (int k = K::sin_degree; k >= 0; --k)
+		{
+			if (k < K::sin_degree) ps = S::fma(ps, u, S::set1(factorial_inverse(2 * k + 1)));
+			pc = S::fma(pc, u, S::set1(factorial_inverse(2 * k)));
+		}
+		ps = S::mul(ps, r);
+
+		type j = S::sub(q, S::mul(S::set1(T(4)), S::floor(S::mul(q, S::set1(T(0.25))))));  // Quadrant 0..3
+		type half = S::mul(j, S::set1(T(0.5)));
+		auto swap = S::less(S::set1(T(0.25)), S::sub(half, S::floor(half)));
+		auto negate_s = S::less(S::set1(T(1.5)), j);
+		auto negate_c = S::less(S::abs(S::sub(j, S::set1(T(1.5)))), S::set1(T(1)));
+		type sv = S::select(swap, pc, ps), cv = S::select(swap, ps, pc);
+
+		s = S::select(negate_s, S::mul(sv, S::set1(T(-1))), sv);
+		c = S::select(negate_c, S::mul(cv, S::set1(T(-1))), cv);
+	}
+
+	static void sinhcosh(type x, type& sh, type& ch)
+	{
+		type a = S::abs(x);
+		auto far = S::less(S::set1(T(20)), a);  // exp(-2|x|) is below the rounding: halve, then square to postpone overflow
+		type e = exp(S::select(far, S::mul(a, S::set1(T(0.5))), a));
+		type ei = S::div(S::set1(T(1)), e);  // One exp serves both
+		type x2 = S::mul(x, x);
+		type p = S::set1(factorial_inverse(2 * K::sin_degree + 1));
+
+		for (int k = K::sin_degree - 1; k >= 0; --k) p = S::fma(p, x2, S::set1(factorial_inverse(2 * k + 1)));
+
+		ch = S::select(far, S::mul(S::mul(e, S::set1(T(0.5))), e), S::mul(S::add(e, ei), S::set1(T(0.5))));
+
+		type big = S::select(far, ch, S::mul(S::sub(e, ei), S::set1(T(0.5))));
+
+		sh = S::select(S::less(a, S::set1(T(0.5))), S::mul(p, x), S::select(S::less(x, S::set1(T())), S::mul(big, S::set1(T(-1))), big));
+	}
+};
+
+//**********************************************************************************************************************
@@ -26,6 +26,8 @@ SOFTWARE.
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <type_traits>
 
 /***********************************************************************************************************************
 *** RegressionAccumulator -- rewindable two variable linear regression and correlation
@@ -33,26 +35,11 @@ SOFTWARE.
 
 template <typename T = double> struct RegressionAccumulator final
 {
-    RegressionAccumulator() noexcept : n(0), mean_x(0), mean_y(0), variance_x(0), variance_y(0), covariance(0)
+    constexpr RegressionAccumulator() noexcept : n(0), mean_x(0), mean_y(0), variance_x(0), variance_y(0), covariance(0)
     {
     }
 
-    RegressionAccumulator(const RegressionAccumulator& r) noexcept : n(r.n), mean_x(r.mean_x), mean_y(r.mean_y), variance_x(r.variance_x), variance_y(r.variance_y), covariance(r.covariance)
-    {
-    }
-
-    RegressionAccumulator& operator=(const RegressionAccumulator& r) noexcept
-    {
-        n = r.n;
-        mean_x = r.mean_x;
-        mean_y = r.mean_y;
-        variance_x = r.variance_x;
-        variance_y = r.variance_y;
-        covariance = r.covariance;
-        return *this;
-    }
-
-    RegressionAccumulator& clear() noexcept
+    constexpr RegressionAccumulator& clear() noexcept
     {
         n = 0;
         mean_x = 0;
@@ -63,7 +50,7 @@ template <typename T = double> struct RegressionAccumulator final
         return *this;
     }
 
-    RegressionAccumulator& insert(T const& x, T const& y) noexcept
+    constexpr RegressionAccumulator& insert(T const& x, T const& y) noexcept
     {
         ++n;
         auto dx = x - mean_x;
@@ -76,7 +63,7 @@ template <typename T = double> struct RegressionAccumulator final
         return *this;
     }
 
-    RegressionAccumulator& remove(T const& x, T const& y) noexcept
+    constexpr RegressionAccumulator& remove(T const& x, T const& y) noexcept
     {
         if (n > 1)
         {
@@ -93,7 +80,52 @@ template <typename T = double> struct RegressionAccumulator final
         return *this;
     }
 
-    T bias() const noexcept
+    RegressionAccumulator& insert(T const* x, T const* y, size_t count) noexcept  // Same as 'count' inserts, but faster
+    {
+        for (size_t i = 0; i < count; i += block)
+        {
+            size_t const m = count - i < block ? count - i : block;
+            RegressionAccumulator b;
+            T sum_x = 0, sum_y = 0;
+
+            for (size_t k = 0; k < m; ++k)
+            {
+                sum_x = sum_x + x[i + k];
+                sum_y = sum_y + y[i + k];
+            }
+            b.n = m;
+            b.mean_x = sum_x / m;
+            b.mean_y = sum_y / m;
+            for (size_t k = 0; k < m; ++k)
+            {
+                auto dx = x[i + k] - b.mean_x;
+                auto dy = y[i + k] - b.mean_y;
+                b.variance_x = b.variance_x + dx * dx;
+                b.variance_y = b.variance_y + dy * dy;
+                b.covariance = b.covariance + dx * dy;
+            }
+            merge(b);
+        }
+        return *this;
+    }
+
+    constexpr RegressionAccumulator& merge(RegressionAccumulator const& r) noexcept  // Combine with another set of samples
+    {
+        if (r.n == 0) return *this;
+        if (n == 0) return *this = r;
+        auto total = n + r.n;
+        auto dx = r.mean_x - mean_x;
+        auto dy = r.mean_y - mean_y;
+        mean_x = mean_x + dx * r.n / total;
+        mean_y = mean_y + dy * r.n / total;
+        variance_x = variance_x + r.variance_x + dx * dx * n * r.n / total;
+        variance_y = variance_y + r.variance_y + dy * dy * n * r.n / total;
+        covariance = covariance + r.covariance + dx * dy * n * r.n / total;
+        n = total;
+        return *this;
+    }
+
+    constexpr T bias() const noexcept
     {
         return mean_y - mean_x * gain();
     }
@@ -103,27 +135,29 @@ template <typename T = double> struct RegressionAccumulator final
         return covariance / sqrt(variance_x * variance_y);
     }
 
-    T gain() const noexcept
+    constexpr T gain() const noexcept
     {
         return covariance / variance_x;
     }
 
-    T operator()(T const& x) const noexcept  // Get linearly correlated 'y' for a given 'x'
+    constexpr T operator()(T const& x) const noexcept  // Get linearly correlated 'y' for a given 'x'
     {
         return mean_y + (x - mean_x) * gain();
     }
 
-    T inv(T const& y) const noexcept  // Get linearly correlated 'x' for a given 'y'
+    constexpr T inv(T const& y) const noexcept  // Get linearly correlated 'x' for a given 'y'
     {
         return mean_x + (y - mean_y) / gain();
     }
 
-    int samples() const noexcept
+    constexpr size_t samples() const noexcept
     {
         return n;
     }
 
 private:
+    static size_t const block = 256;  // Bulk inserts merge blocks of this many samples
+
     size_t n;
     T mean_x;
     T mean_y;
@@ -138,23 +172,11 @@ private:
 
 template <typename T = double> struct StatisticsAccumulator final
 {
-    StatisticsAccumulator() noexcept : n(0), mean_x(0), variance_x(0)
+    constexpr StatisticsAccumulator() noexcept : n(0), mean_x(0), variance_x(0)
     {
     }
 
-    StatisticsAccumulator(const StatisticsAccumulator& r) noexcept : n(r.n), mean_x(r.mean_x), variance_x(r.variance_x)
-    {
-    }
-
-    StatisticsAccumulator& operator=(const StatisticsAccumulator& r) noexcept
-    {
-        n = r.n;
-        mean_x = r.mean_x;
-        variance_x = r.variance_x;
-        return *this;
-    }
-
-    StatisticsAccumulator& clear() noexcept
+    constexpr StatisticsAccumulator& clear() noexcept
     {
         n = 0;
         mean_x = 0;
@@ -162,7 +184,7 @@ template <typename T = double> struct StatisticsAccumulator final
         return *this;
     }
 
-    StatisticsAccumulator& insert(T const& x) noexcept
+    constexpr StatisticsAccumulator& insert(T const& x) noexcept
     {
         ++n;
         auto dx = x - mean_x;
@@ -171,7 +193,7 @@ template <typename T = double> struct StatisticsAccumulator final
         return *this;
     }
 
-    StatisticsAccumulator& remove(T const& x) noexcept
+    constexpr StatisticsAccumulator& remove(T const& x) noexcept
     {
         if (n > 1)
         {
@@ -184,7 +206,40 @@ template <typename T = double> struct StatisticsAccumulator final
         return *this;
     }
 
-    T average() const noexcept
+    StatisticsAccumulator& insert(T const* x, size_t count) noexcept  // Same as 'count' inserts, but faster
+    {
+        for (size_t i = 0; i < count; i += block)
+        {
+            size_t const m = count - i < block ? count - i : block;
+            StatisticsAccumulator b;
+            T sum_x = 0;
+
+            for (size_t k = 0; k < m; ++k) sum_x = sum_x + x[i + k];
+            b.n = m;
+            b.mean_x = sum_x / m;
+            for (size_t k = 0; k < m; ++k)
+            {
+                auto dx = x[i + k] - b.mean_x;
+                b.variance_x = b.variance_x + dx * dx;
+            }
+            merge(b);
+        }
+        return *this;
+    }
+
+    constexpr StatisticsAccumulator& merge(StatisticsAccumulator const& r) noexcept  // Combine with another set of samples
+    {
+        if (r.n == 0) return *this;
+        if (n == 0) return *this = r;
+        auto total = n + r.n;
+        auto dx = r.mean_x - mean_x;
+        mean_x = mean_x + dx * r.n / total;
+        variance_x = variance_x + r.variance_x + dx * dx * n * r.n / total;
+        n = total;
+        return *this;
+    }
+
+    constexpr T average() const noexcept
     {
         return mean_x;
     }
@@ -199,27 +254,29 @@ template <typename T = double> struct StatisticsAccumulator final
         return sqrt(variance_s());
     }
 
-    T sum() const noexcept
+    constexpr T sum() const noexcept
     {
         return n * average();
     }
 
-    T variance_p() const noexcept
+    constexpr T variance_p() const noexcept
     {
         return variance_x / n;
     }
 
-    T variance_s() const noexcept
+    constexpr T variance_s() const noexcept
     {
         return variance_x / (n - 1);
     }
 
-    int samples() const noexcept
+    constexpr size_t samples() const noexcept
     {
         return n;
     }
 
 private:
+    static size_t const block = 256;  // Bulk inserts merge blocks of this many samples
+
     size_t n;
     T mean_x;
     T variance_x;
@@ -231,23 +288,11 @@ private:
 
 template <typename T = double> struct GeneralizedMean final
 {
-    GeneralizedMean(double d = 1) noexcept : exponent(d), count(0), accumulator(0)
+    constexpr GeneralizedMean(double d = 1) noexcept : exponent(d), count(0), accumulator(0)
     {
     }
 
-    GeneralizedMean(const GeneralizedMean& r) noexcept : exponent(r.exponent), count(r.count), accumulator(r.accumulator)
-    {
-    }
-
-    GeneralizedMean& operator=(const GeneralizedMean& r) noexcept
-    {
-        exponent = r.exponent;
-        count = r.count;
-        accumulator = r.accumulator;
-        return *this;
-    }
-
-    GeneralizedMean& reset(double d) noexcept
+    constexpr GeneralizedMean& reset(double d) noexcept
     {
         exponent = d;
         count = 0;
@@ -279,3 +324,13 @@ private:
 };
 
 //**********************************************************************************************************************
+
+static_assert(std::is_trivially_copyable_v<RegressionAccumulator<double>> && std::is_standard_layout_v<RegressionAccumulator<double>>);
+static_assert(std::is_trivially_copyable_v<StatisticsAccumulator<double>> && std::is_standard_layout_v<StatisticsAccumulator<double>>);
+static_assert(std::is_trivially_copyable_v<GeneralizedMean<double>> && std::is_standard_layout_v<GeneralizedMean<double>>);
+
+static_assert(StatisticsAccumulator<double>().insert(1).insert(2).insert(6).average() == 3);
+static_assert(RegressionAccumulator<double>().insert(1, 3).insert(2, 5).gain() == 2);
+static_assert(StatisticsAccumulator<double>().insert(1).merge(StatisticsAccumulator<double>().insert(2).insert(6)).average() == 3);
+
+//**********************************************************************************************************************
@@ -0,0 +1,550 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Micro-benchmarks for the hot paths.  Usage:  mathbits_bench [--min-time=ms] [--repetitions=n] [name-filter ...]
+//
+// Prints one JSON document to stdout: per case the median ns/op over the repetitions, operations and bytes per
+// second, and where Linux perf_event is available (see /proc/sys/kernel/perf_event_paranoid) cycles, instructions
+// per cycle and cache misses per operation.  Counters that cannot be opened or read are reported as null.
+
+#include "AccumulatorTable.h"
+#include "AnomalyDetector.h"
+#include "Complex.h"
+#include "Correlogram.h"
+#include "Downsampler.h"
+#include "Dual.h"
+#include "FFT.h"
+#include "Functions.h"
+#include "Geometry3D.h"
+#include "Polylog2.h"
+#include "Statistics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************************************************************************
+*** PerfCounters -- user space cycles, instructions and cache misses of the calling thread, as one group
+***********************************************************************************************************************/
+
+// Cycles lead the group so all three are scheduled on the PMU together and their ratios are meaningful; if the
+// kernel multiplexes the group, counts are scaled up by the time enabled over the time running.
+
+#if defined(__linux__)
+
+struct PerfCounters final
+{
+    enum { Cycles, Instructions, CacheMisses, Count };
+
+    PerfCounters()
+    {
+        uint64_t const config[Count] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+
+        for (int i = 0; i < Count; ++i)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = config[i];
+            attr.disabled = i == 0;  // Members follow the leader
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd[i] = i == 0 || fd[0] >= 0 ? int(syscall(__NR_perf_event_open, &attr, 0, -1, i ? fd[0] : -1, 0)) : -1;
+        }
+    }
+
+    PerfCounters(PerfCounters const&) = delete;
+    PerfCounters& operator=(PerfCounters const&) = delete;
+
+    ~PerfCounters()
+    {
+        for (int i = Count; i-- > 0;) if (fd[i] >= 0) close(fd[i]);
+    }
+
+    bool valid() const
+    {
+        return fd[0] >= 0;
+    }
+
+    void start()
+    {
+        if (fd[0] < 0) return;
+        ioctl(fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop()
+    {
+        if (fd[0] >= 0) ioctl(fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void read(double (&count)[Count]) const  // Negative for counters that could not be opened or read
+    {
+        uint64_t data[3 + Count];  // nr, time enabled, time running, then the values in the order the events joined
+        ssize_t const size = fd[0] < 0 ? -1 : ::read(fd[0], data, sizeof(data));
+        size_t const values = size < ssize_t(3 * sizeof(uint64_t)) || data[2] == 0 ? 0 : std::min<size_t>(data[0], size / sizeof(uint64_t) - 3);
+
+        for (size_t i = 0, j = 0; i < Count; ++i)
+        {
+            count[i] = -1;
+            if (fd[i] >= 0 && j < values) count[i] = double(data[3 + j++]) * double(data[1]) / double(data[2]);
+        }
+    }
+
+private:
+    int fd[Count];
+};
+
+#else
+
+struct PerfCounters final  // No counters on this platform
+{
+    enum { Cycles, Instructions, CacheMisses, Count };
+
+    bool valid() const { return false; }
+    void start() { }
+    void stop() { }
+    void read(double (&count)[Count]) const { std::fill(count, count + Count, -1.0); }
+};
+
+#endif
+
+/***********************************************************************************************************************
+*** Benchmark harness
+***********************************************************************************************************************/
+
+template <typename T> void keep(T const& r)  // Makes 'r' observable so the computation producing it is not elided
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&r) : "memory");
+#else
+    static void const* volatile sink;
+    sink = &r;
+#endif
+}
+
+struct Case final
+{
+    std::string name;
+    size_t ops;                  // Operations per call of 'run'
+    size_t bytes;                // Bytes read and written per operation, or 0 if not meaningful
+    std::function<void()> run;
+};
+
+struct Result final
+{
+    double ns_per_op;
+    double cycles;               // Per operation; negative if unavailable
+    double instructions;
+    double cache_misses;
+};
+
+static Result measure(Case const& c, double min_time, int repetitions)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto seconds = [&](size_t calls)
+    {
+        auto const start = Clock::now();
+        for (size_t i = 0; i < calls; ++i) c.run();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    double const target = min_time / repetitions;
+    size_t calls = 1;
+    double elapsed = seconds(calls);  // Also warms up caches and lazily built state
+
+    while (elapsed < target / 8)
+    {
+        calls *= 2;
+        elapsed = seconds(calls);
+    }
+    calls = std::max<size_t>(1, size_t(calls * target / std::max(elapsed, 1e-9)));
+
+    PerfCounters counters;
+    std::vector<double> samples;
+
+    counters.start();
+    for (int r = 0; r < repetitions; ++r) samples.push_back(seconds(calls) * 1e9 / (double(calls) * c.ops));
+    counters.stop();
+
+    std::sort(samples.begin(), samples.end());
+
+    double count[PerfCounters::Count];
+    counters.read(count);
+
+    double const total = double(calls) * c.ops * repetitions;
+    auto per_op = [&](int i) { return count[i] < 0 ? -1.0 : count[i] / total; };
+
+    return { samples[samples.size() / 2], per_op(PerfCounters::Cycles), per_op(PerfCounters::Instructions), per_op(PerfCounters::CacheMisses) };
+}
+
+static void print_number(double x)
+{
+    if (x < 0) printf("null");
+    else printf("%.6g", x);
+}
+
+/***********************************************************************************************************************
+*** Cases
+***********************************************************************************************************************/
+
+static size_t const N = 4096;  // Elements per batch; small enough that the working set stays in L1/L2
+
+static std::vector<double> uniform(double a, double b, size_t n = N)
+{
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> distribution(a, b);
+    std::vector<double> result(n);
+    for (auto& x : result) x = distribution(rng);
+    return result;
+}
+
+template <typename F> static Case scalar(char const* name, std::vector<double> x, F const& f)  // y = f(x) elementwise
+{
+    auto in = std::make_shared<std::vector<double>>(std::move(x));
+    auto out = std::make_shared<std::vector<double>>(in->size());
+
+    return { name, in->size(), 2 * sizeof(double), [=]
+    {
+        for (size_t i = 0; i < in->size(); ++i) (*out)[i] = f((*in)[i]);
+        keep(out->front());
+    } };
+}
+
+template <typename F> static Case batch(char const* name, std::vector<double> x, F const& f)  // f(x, y, n)
+{
+    auto in = std::make_shared<std::vector<double>>(std::move(x));
+    auto out = std::make_shared<std::vector<double>>(in->size());
+
+    return { name, in->size(), 2 * sizeof(double), [=]
+    {
+        f(in->data(), out->data(), in->size());
+        keep(out->front());
+    } };
+}
+
+static std::vector<Case> cases()
+{
+    std::vector<Case> result;
+
+    // Accumulators: a sliding window, so every operation is one insert and one remove
+
+    {
+        auto x = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        size_t const window = 64;
+
+        result.push_back({ "statistics_insert_remove", N - window, sizeof(double), [=]
+        {
+            StatisticsAccumulator<double> acc;
+            for (size_t i = 0; i < window; ++i) acc.insert((*x)[i]);
+            for (size_t i = window; i < N; ++i) acc.insert((*x)[i]).remove((*x)[i - window]);
+            keep(acc);
+        } });
+
+        result.push_back({ "statistics_bulk_insert", N, sizeof(double), [=]
+        {
+            StatisticsAccumulator<double> acc;
+            acc.insert(x->data(), N);
+            keep(acc);
+        } });
+
+        auto y = std::make_shared<std::vector<double>>(uniform(-1, 1));
+
+        result.push_back({ "regression_insert_remove", N - window, 2 * sizeof(double), [=]
+        {
+            RegressionAccumulator<double> acc;
+            for (size_t i = 0; i < window; ++i) acc.insert((*x)[i], (*y)[i]);
+            for (size_t i = window; i < N; ++i) acc.insert((*x)[i], (*y)[i]).remove((*x)[i - window], (*y)[i - window]);
+            keep(acc);
+        } });
+    }
+
+    // Correlogram over lags 0 ... 1024 on a sliding window; one operation is one insert and one remove
+
+    {
+        auto x = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        auto acc = std::make_shared<CorrelogramAccumulator<double>>(1024);
+
+        for (size_t i = 0; i < 2048; ++i) acc->insert((*x)[i]);
+
+        result.push_back({ "correlogram_1024_insert_remove", N, sizeof(double), [=]
+        {
+            for (size_t i = 0; i < N; ++i) acc->insert((*x)[i]).remove();
+            keep(*acc);
+        } });
+    }
+
+    // Downsampling to 1s, 1m and 1h buckets at 1 kHz on milliseconds, in batches arriving up to 15 ms out of order
+
+    {
+        auto x = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        auto t = std::make_shared<std::vector<int64_t>>(N);
+        auto d = std::make_shared<Downsampler<double>>(std::initializer_list<Downsampler<double>::Resolution>{ { 1000, 3600 }, { 60000, 1440 }, { 3600000, 720 } }, 100);
+        auto clock = std::make_shared<int64_t>(0);
+
+        result.push_back({ "downsampler_insert", N, sizeof(int64_t) + sizeof(double), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*t)[i] = *clock + int64_t(i ^ 15);
+            *clock += N;
+            d->insert(t->data(), x->data(), N);
+        } });
+    }
+
+    // Anomaly detection on N streams; one operation is one stream's update in a tick, against StatisticsAccumulators
+
+    {
+        auto x = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        auto y = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        auto bank = std::make_shared<DetectorBank<double>>(N, 64);
+        auto acc = std::make_shared<std::vector<StatisticsAccumulator<double>>>(N);
+        auto ticks = std::make_shared<size_t>(0);
+
+        result.push_back({ "detector_bank_tick", N, sizeof(double), [=]
+        {
+            keep(bank->tick((++*ticks & 1 ? x : y)->data()).size());  // Alternating, so that the variances stay put
+        } });
+
+        result.push_back({ "statistics_zscore_per_stream", N, sizeof(double), [=]
+        {
+            size_t alarms = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                auto& a = (*acc)[i];
+                alarms += std::abs((*x)[i] - a.average()) > 4 * a.stdev_p();
+                a.insert((*x)[i]);
+            }
+            keep(alarms);
+        } });
+    }
+
+    // Group-by: updates spread over a million keys, so that nearly every one misses the caches
+
+    {
+        size_t const keys = size_t(1) << 20;
+        auto x = std::make_shared<std::vector<double>>(uniform(-1, 1));
+        auto key = std::make_shared<std::vector<uint64_t>>(N);
+        auto table = std::make_shared<AccumulatorTable<uint64_t>>(keys);
+        auto map = std::make_shared<std::unordered_map<uint64_t, StatisticsAccumulator<double>>>(keys);
+        std::mt19937_64 rng(1);
+
+        for (uint64_t k = 0; k < keys; ++k)
+        {
+            (*table)[k * 7919].insert(0);
+            (*map)[k * 7919].insert(0);
+        }
+
+        for (auto& k : *key) k = rng() % keys * 7919;
+
+        result.push_back({ "accumulator_table_insert", N, sizeof(uint64_t) + sizeof(double), [=]
+        {
+            table->insert(key->data(), x->data(), N);
+        } });
+
+        result.push_back({ "unordered_map_insert", N, sizeof(uint64_t) + sizeof(double), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*map)[(*key)[i]].insert((*x)[i]);
+        } });
+    }
+
+    // Quaternions
+
+    {
+        auto c = uniform(-1, 1, 3 * N);
+        auto v = std::make_shared<std::vector<Vector<double>>>(N);
+        auto q = std::make_shared<std::vector<Quaternion<double>>>(N);
+        auto out = std::make_shared<std::vector<Vector<double>>>(N);
+        auto qout = std::make_shared<std::vector<Quaternion<double>>>(N);
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            (*v)[i] = Vector<double>(c[3 * i], c[3 * i + 1], c[3 * i + 2]);
+            (*q)[i] = normalize(Quaternion<double>(1, (*v)[i]));
+        }
+
+        Quaternion<double> const rotation = normalize(Quaternion<double>(0.9, 0.1, -0.3, 0.2));
+
+        result.push_back({ "quaternion_rotate", N, 2 * sizeof(Vector<double>), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*out)[i] = rotation((*v)[i]);
+            keep(out->front());
+        } });
+
+        result.push_back({ "quaternion_exp", N, 2 * sizeof(Quaternion<double>), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*qout)[i] = exp((*q)[i]);
+            keep(qout->front());
+        } });
+
+        result.push_back({ "quaternion_log", N, 2 * sizeof(Quaternion<double>), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*qout)[i] = log((*q)[i]);
+            keep(qout->front());
+        } });
+
+        result.push_back({ "quaternion_pow", N, 2 * sizeof(Quaternion<double>), [=]
+        {
+            for (size_t i = 0; i < N; ++i) (*qout)[i] = pow((*q)[i], 0.5);
+            keep(qout->front());
+        } });
+    }
+
+    // Complex and dual number exp, log and pow
+
+    {
+        auto a = std::make_shared<ComplexArray<double>>(N);
+        auto z = std::make_shared<ComplexArray<double>>(N);
+        auto re = uniform(-5, 5), im = uniform(-10, 10);
+
+        for (size_t i = 0; i < N; ++i) a->set(i, { re[i], im[i] });
+
+        result.push_back({ "complex_exp", N, 2 * sizeof(Complex<double>), [=]
+        {
+            for (size_t i = 0; i < N; ++i) z->set(i, exp((*a)[i]));
+            keep(z->re.front());
+        } });
+
+        result.push_back({ "complex_exp_batch", N, 2 * sizeof(Complex<double>), [=]
+        {
+            exp(*z, *a);
+            keep(z->re.front());
+        } });
+
+        result.push_back(scalar("dual_exp", uniform(-5, 5), [](double x) { auto const y = exp(Dual<double>(x, 0)); return y.v + y.d[0]; }));
+        result.push_back(scalar("dual_log", uniform(0.01, 10), [](double x) { auto const y = log(Dual<double>(x, 0)); return y.v + y.d[0]; }));
+        result.push_back(scalar("dual_pow", uniform(0.01, 10), [](double x) { auto const y = pow(Dual<double>(x, 0), 2.5); return y.v + y.d[0]; }));
+    }
+
+    // Polylogarithm and integral of SoftPlus
+
+    result.push_back(scalar("li2", uniform(-4, 1), [](double x) { return Li2(x); }));
+    result.push_back(scalar("spp", uniform(-20, 20), [](double x) { return Spp(x); }));
+    result.push_back(scalar("spp_table_cubic", uniform(-20, 20), [](double x) { return SppTable<1024, 3>::evaluate(x); }));
+
+    // Activation functions
+
+    result.push_back(scalar("logistic", uniform(-20, 20), [](double x) { return Logistic(x); }));
+    result.push_back(scalar("softplus", uniform(-20, 20), [](double x) { return SoftPlus(x); }));
+    result.push_back(scalar("logistic_table_cubic", uniform(-20, 20), [](double x) { return LogisticTable<1024, 3>::evaluate(x); }));
+    result.push_back(batch("costw_batch", uniform(-3, 3), [](double const* x, double* y, size_t n) { CostW(x, y, n); }));
+    result.push_back(batch("invact_batch", uniform(-3, 3), [](double const* x, double* y, size_t n) { InvAct(x, y, n); }));
+    result.push_back(batch("relu_batch", uniform(-3, 3), [](double const* x, double* y, size_t n) { ReLU(x, y, n); }));
+    result.push_back(batch("logistic_batch", uniform(-20, 20), [](double const* x, double* y, size_t n) { Logistic(x, y, n); }));
+    result.push_back(batch("logistic_batch_fast", uniform(-20, 20), [](double const* x, double* y, size_t n) { Logistic(x, y, n, Accuracy::Fast); }));
+    result.push_back(batch("softplus_batch", uniform(-20, 20), [](double const* x, double* y, size_t n) { SoftPlus(x, y, n); }));
+    result.push_back(batch("softplus_batch_fast", uniform(-20, 20), [](double const* x, double* y, size_t n) { SoftPlus(x, y, n, Accuracy::Fast); }));
+
+    // FFT, single threaded size (below FFTPlan::parallel_threshold)
+
+    {
+        auto plan = FFTPlan<double>::get(N);
+        auto in = std::make_shared<std::vector<Complex<double>>>(N), out = std::make_shared<std::vector<Complex<double>>>(N);
+        auto re = uniform(-1, 1);
+
+        for (size_t i = 0; i < N; ++i) (*in)[i] = Complex<double>(re[i], 0);
+
+        result.push_back({ "fft_4096", N, 2 * sizeof(Complex<double>), [=]
+        {
+            plan->forward(in->data(), out->data());
+            keep(out->front());
+        } });
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************
+*** main
+***********************************************************************************************************************/
+
+int main(int argc, char const* argv[])
+{
+    double min_time = 0.2;
+    int repetitions = 5;
+    std::vector<std::string> filters;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const arg = argv[i];
+
+        if (arg.rfind("--min-time=", 0) == 0) min_time = std::max(1.0, atof(arg.c_str() + 11)) / 1000;
+        else if (arg.rfind("--repetitions=", 0) == 0) repetitions = std::max(1, atoi(arg.c_str() + 14));
+        else if (arg.rfind("--", 0) == 0)
+        {
+            fprintf(stderr, "usage: %s [--min-time=ms] [--repetitions=n] [name-filter ...]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        else filters.push_back(arg);
+    }
+
+    bool const counters = PerfCounters().valid();
+    bool first = true;
+
+    printf("{\n  \"perf_counters\": %s,\n  \"simd_width\": %d,\n  \"benchmarks\": [", counters ? "true" : "false", int(Simd<double>::width));
+
+    for (auto const& c : cases())
+    {
+        if (!filters.empty() && std::none_of(filters.begin(), filters.end(), [&](std::string const& f) { return c.name.find(f) != std::string::npos; })) continue;
+
+        auto const r = measure(c, min_time, repetitions);
+
+        printf("%s\n    { \"name\": \"%s\", \"ns_per_op\": ", first ? "" : ",", c.name.c_str());
+        print_number(r.ns_per_op);
+        printf(", \"ops_per_sec\": ");
+        print_number(1e9 / r.ns_per_op);
+        printf(", \"bytes_per_sec\": ");
+        print_number(c.bytes ? 1e9 * c.bytes / r.ns_per_op : -1);
+        printf(", \"cycles_per_op\": ");
+        print_number(r.cycles);
+        printf(", \"ipc\": ");
+        print_number(r.cycles > 0 && r.instructions >= 0 ? r.instructions / r.cycles : -1);
+        printf(", \"cache_misses_per_op\": ");
+        print_number(r.cache_misses);
+        printf(" }");
+        fflush(stdout);
+        first = false;
+    }
+
+    printf("\n  ]\n}\n");
+
+    return EXIT_SUCCESS;
+}
@@ -1,18 +1,523 @@
 
-#include "Complex.h"
-#include "Geometry3D.h"
-#include "MathBits.h"
-#include "Polylog2.h"
+/*
+MIT License
 
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Summary statistics of every column and linear regression of every column pair of a numeric file
+//
+// usage: mathbits-stats [options] file
+//
+//   --format=csv|f64|f32    Text, or raw little endian doubles or floats; by default .f64 and .f32 files are binary
+//   --columns=n             Number of columns; required for the binary formats
+//   --layout=columns|rows   Binary data stored one column after another (default) or as interleaved rows
+//   --delimiter=c           CSV field separator (default ',')
+//   --threads=n             Worker threads (default: one per hardware thread)
+//   --no-pairs              Skip the column pair regressions
+//
+// The file is memory mapped and split into one chunk per thread; every chunk is reduced into its own accumulators,
+// which are merged at the end.  In CSV input a first line that does not parse as numbers names the columns, and empty
+// or non-numeric fields are missing values, left out of their column and of every pair involving it on that row.  NaNs
+// in binary input are missing values in the same way.
+
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::cout;
 using std::endl;
 
+/***********************************************************************************************************************
+*** MappedFile -- read only view of a whole file
+***********************************************************************************************************************/
+
+struct MappedFile final
+{
+    explicit MappedFile(std::string const& path) : base(nullptr), length(0)
+    {
+#if defined(_WIN32)
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw "Cannot open " + path;
+        copy.resize(size_t(in.tellg()));
+        in.seekg(0).read(copy.data(), copy.size());
+        base = copy.data();
+        length = copy.size();
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw "Cannot open " + path + ": " + strerror(errno);
+
+        struct stat info;
+        if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode))
+        {
+            close(fd);
+            throw path + " is not a regular file";
+        }
+        length = size_t(info.st_size);
+
+        if (length)
+        {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                close(fd);
+                throw "Cannot map " + path + ": " + strerror(errno);
+            }
+            madvise(p, length, MADV_SEQUENTIAL);  // Advice values are codes, not flags: one call each
+            madvise(p, length, MADV_WILLNEED);
+            base = static_cast<char const*>(p);
+        }
+        close(fd);
+#endif
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile()
+    {
+#if !defined(_WIN32)
+        if (base) munmap(const_cast<char*>(base), length);
+#endif
+    }
+
+    char const* data() const
+    {
+        return base;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+private:
+    char const* base;
+    size_t length;
+#if defined(_WIN32)
+    std::vector<char> copy;
+#endif
+};
+
+/***********************************************************************************************************************
+*** Summary -- per column statistics and per column pair regressions of one chunk
+***********************************************************************************************************************/
+
+struct Summary final
+{
+    Summary(size_t columns, bool pairs) : column(columns), pair(pairs ? columns * (columns - 1) / 2 : 0),
+        lo(columns, std::numeric_limits<double>::infinity()), hi(columns, -std::numeric_limits<double>::infinity())
+    {
+    }
+
+    void insert(double const* x)  // One row; NaN marks a missing value
+    {
+        size_t const columns = column.size();
+
+        for (size_t i = 0; i < columns; ++i)
+        {
+            if (x[i] != x[i]) continue;
+            column[i].insert(x[i]);
+            lo[i] = std::min(lo[i], x[i]);
+            hi[i] = std::max(hi[i], x[i]);
+        }
+
+        for (size_t i = 0, k = 0; k < pair.size(); ++i)
+        {
+            for (size_t j = i + 1; j < columns; ++j, ++k)
+            {
+                if (x[i] == x[i] && x[j] == x[j]) pair[k].insert(x[i], x[j]);
+            }
+        }
+    }
+
+    void insert(double const* const* x, size_t count)  // 'count' rows given column by column; NaN marks a missing value
+    {
+        size_t const columns = column.size();
+        bool complete = true;
+
+        for (size_t i = 0; i < columns; ++i)
+        {
+            for (size_t r = 0; r < count; ++r) complete &= x[i][r] == x[i][r];
+        }
+
+        if (!complete)  // Row by row, which leaves the missing values out
+        {
+            std::vector<double> row(columns);
+
+            for (size_t r = 0; r < count; ++r)
+            {
+                for (size_t i = 0; i < columns; ++i) row[i] = x[i][r];
+                insert(row.data());
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < columns; ++i)
+        {
+            column[i].insert(x[i], count);
+            for (size_t r = 0; r < count; ++r)
+            {
+                lo[i] = std::min(lo[i], x[i][r]);
+                hi[i] = std::max(hi[i], x[i][r]);
+            }
+        }
+
+        for (size_t i = 0, k = 0; k < pair.size(); ++i)
+        {
+            for (size_t j = i + 1; j < columns; ++j, ++k) pair[k].insert(x[i], x[j], count);
+        }
+    }
+
+    void merge(Summary const& r)
+    {
+        for (size_t i = 0; i < column.size(); ++i)
+        {
+            column[i].merge(r.column[i]);
+            lo[i] = std::min(lo[i], r.lo[i]);
+            hi[i] = std::max(hi[i], r.hi[i]);
+        }
+        for (size_t k = 0; k < pair.size(); ++k) pair[k].merge(r.pair[k]);
+    }
+
+    std::vector<StatisticsAccumulator<double>> column;
+    std::vector<RegressionAccumulator<double>> pair;  // (0, 1), (0, 2) ... (1, 2) ...
+    std::vector<double> lo;
+    std::vector<double> hi;
+};
+
+/***********************************************************************************************************************
+*** CSV
+***********************************************************************************************************************/
+
+static double const missing = std::numeric_limits<double>::quiet_NaN();
+
+static bool blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static char const* field(char const* p, char const* eol, char delimiter, double& value)  // Returns the field's end
+{
+    auto end = static_cast<char const*>(memchr(p, delimiter, size_t(eol - p)));
+    if (!end) end = eol;
+
+    char const* a = p;
+    char const* b = end;
+
+    while (a < b && blank(*a)) ++a;
+    while (b > a && blank(b[-1])) --b;
+    if (a < b && *a == '+') ++a;
+
+    auto const result = std::from_chars(a, b, value);
+    if (a == b || result.ec != std::errc() || result.ptr != b) value = missing;
+
+    return end;
+}
+
+static char const* line_end(char const* p, char const* end)
+{
+    auto eol = static_cast<char const*>(memchr(p, '\n', size_t(end - p)));
+    return eol ? eol : end;
+}
+
+static void parse_csv(char const* p, char const* end, char delimiter, Summary& summary)  // Whole lines only
+{
+    std::vector<double> row(summary.column.size());
+
+    while (p < end)
+    {
+        char const* const eol = line_end(p, end);
+        bool empty = true;
+
+        for (double& x : row)
+        {
+            if (p <= eol)
+            {
+                p = field(p, eol, delimiter, x) + 1;
+                empty = empty && x != x;
+            }
+            else x = missing;
+        }
+
+        if (!empty) summary.insert(row.data());
+        p = eol + 1;
+    }
+}
+
+static std::vector<std::string> csv_header(char const*& p, char const* end, char delimiter)  // Consumes named headers
+{
+    char const* const eol = line_end(p, end);
+    std::vector<std::string> names;
+    bool numeric = true;
+
+    for (char const* q = p; q <= eol; )
+    {
+        double x;
+        char const* const next = field(q, eol, delimiter, x);
+        char const* a = q;
+        char const* b = next;
+
+        while (a < b && blank(*a)) ++a;
+        while (b > a && blank(b[-1])) --b;
+        numeric = numeric && (x == x || a == b);
+        names.emplace_back(a, b);
+        q = next + 1;
+    }
+
+    if (numeric)
+    {
+        for (size_t i = 0; i < names.size(); ++i) names[i] = std::to_string(i + 1);
+    }
+    else p = eol + 1;
+
+    return names;
+}
+
+/***********************************************************************************************************************
+*** Raw binary columns
+***********************************************************************************************************************/
+
+template <typename F> static double load(char const* p)  // Little endian F at any alignment
+{
+    F x;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    char swapped[sizeof(F)];
+    std::reverse_copy(p, p + sizeof(F), swapped);
+    memcpy(&x, swapped, sizeof(F));
+#else
+    memcpy(&x, p, sizeof(F));
+#endif
+    return double(x);
+}
+
+template <typename F> static void parse_binary(char const* data, size_t rows, size_t first, size_t last, bool by_rows, Summary& summary)
+{
+    size_t const block = 1024;
+    size_t const columns = summary.column.size();
+    std::vector<double> buffer(columns * block);
+    std::vector<double const*> x(columns);
+
+    for (size_t c = 0; c < columns; ++c) x[c] = buffer.data() + c * block;
+
+    for (size_t r = first; r < last; r += block)
+    {
+        size_t const count = std::min(block, last - r);
+
+        for (size_t c = 0; c < columns; ++c)
+        {
+            double* const out = buffer.data() + c * block;
+
+            if (by_rows)
+            {
+                for (size_t k = 0; k < count; ++k) out[k] = load<F>(data + ((r + k) * columns + c) * sizeof(F));
+            }
+            else
+            {
+                char const* const in = data + (c * rows + r) * sizeof(F);
+                for (size_t k = 0; k < count; ++k) out[k] = load<F>(in + k * sizeof(F));
+            }
+        }
+        summary.insert(x.data(), count);
+    }
+}
+
+/***********************************************************************************************************************
+*** main
+***********************************************************************************************************************/
+
+struct Options final
+{
+    std::string path;
+    std::string format;
+    size_t columns = 0;
+    bool by_rows = false;
+    char delimiter = ',';
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool pairs = true;
+};
+
+static char const* const usage = "usage: mathbits-stats [--format=csv|f64|f32] [--columns=n] [--layout=columns|rows] [--delimiter=c] [--threads=n] [--no-pairs] file";
+
+template <typename U> static U parse_count(char const* option, char const* v)  // Whole decimal value or a usage error
+{
+    U value = 0;
+    char const* const end = v + strlen(v);
+    auto const result = std::from_chars(v, end, value);
+    if (result.ec != std::errc() || result.ptr != end) throw std::string("invalid ") + option + " value\n" + usage;
+    return value;
+}
+
+static Options parse_options(int argc, char const* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const arg = argv[i];
+        auto value = [&](char const* name) { return arg.rfind(name, 0) == 0 ? arg.c_str() + strlen(name) : nullptr; };
+
+        if (auto v = value("--format=")) options.format = v;
+        else if (auto v = value("--columns=")) options.columns = parse_count<size_t>("--columns", v);
+        else if (auto v = value("--layout=")) options.by_rows = std::string(v) == "rows";
+        else if (auto v = value("--delimiter=")) options.delimiter = *v ? (std::string(v) == "\\t" ? '\t' : *v) : ',';
+        else if (auto v = value("--threads=")) options.threads = std::max(parse_count<unsigned>("--threads", v), 1u);
+        else if (arg == "--no-pairs") options.pairs = false;
+        else if (arg.rfind("--", 0) == 0 || !options.path.empty()) throw "Unknown argument " + arg;
+        else options.path = arg;
+    }
+
+    if (options.path.empty())
+    {
+        throw std::string(usage);
+    }
+
+    if (options.format.empty())
+    {
+        auto const dot = options.path.rfind('.');
+        std::string const extension = dot == std::string::npos ? "" : options.path.substr(dot + 1);
+        options.format = extension == "f64" || extension == "f32" ? extension : "csv";
+    }
+
+    if (options.format != "csv" && options.format != "f64" && options.format != "f32") throw "Unknown format " + options.format;
+    if (options.format != "csv" && options.columns == 0) throw std::string("Binary input needs --columns");
+
+    return options;
+}
+
+template <typename F> static void run(unsigned threads, Summary& total, F const& chunk)  // chunk(index, threads, summary)
+{
+    std::vector<Summary> partial(threads, total);
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back([&, t] { chunk(t, threads, partial[t]); });
+    chunk(0, threads, partial[0]);
+    for (auto& thread : pool) thread.join();
+
+    for (auto const& s : partial) total.merge(s);
+}
+
+static void report(std::vector<std::string> const& names, Summary const& total)
+{
+    cout << std::setprecision(8);
+    cout << "column\tcount\tmean\tstdev\tmin\tmax" << endl;
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        auto const& c = total.column[i];
+        cout << names[i] << "\t" << c.samples() << "\t" << c.average() << "\t" << c.stdev_s() << "\t" << total.lo[i] << "\t" << total.hi[i] << endl;
+    }
+
+    if (total.pair.empty()) return;
+
+    cout << endl << "x\ty\tcount\tcorrelation\tgain\tbias" << endl;
+
+    for (size_t i = 0, k = 0; i < names.size(); ++i)
+    {
+        for (size_t j = i + 1; j < names.size(); ++j, ++k)
+        {
+            auto const& p = total.pair[k];
+            cout << names[i] << "\t" << names[j] << "\t" << p.samples() << "\t" << p.correlation() << "\t" << p.gain() << "\t" << p.bias() << endl;
+        }
+    }
+}
+
 int main(int argc, char const* argv[]) try
 {
-    Complex<double> a;
+    auto const options = parse_options(argc, argv);
+    auto const start = std::chrono::steady_clock::now();
+
+    MappedFile file(options.path);
+    char const* const data = file.data();
+    char const* const end = data + file.size();
+    char const* body = data;
+    unsigned const threads = unsigned(std::min<size_t>(options.threads, std::max<size_t>(file.size() >> 20, 1)));  // >= 1 MB each
+    std::vector<std::string> names;
+
+    if (options.format == "csv")
+    {
+        names = csv_header(body, end, options.delimiter);
+        if (options.columns) names.resize(options.columns);
+        for (size_t i = 0; i < names.size(); ++i) if (names[i].empty()) names[i] = std::to_string(i + 1);
+    }
+    else
+    {
+        for (size_t i = 0; i < options.columns; ++i) names.push_back(std::to_string(i + 1));
+    }
+
+    Summary total(names.size(), options.pairs);
+
+    if (options.format == "csv")
+    {
+        run(threads, total, [&](unsigned t, unsigned n, Summary& summary)
+        {
+            auto boundary = [&](unsigned k)  // Every chunk starts at a line start
+            {
+                if (k == 0) return body;
+                if (k == n) return end;
+                return std::min(line_end(body + size_t(end - body) * k / n - 1, end) + 1, end);
+            };
+            parse_csv(boundary(t), std::max(boundary(t), boundary(t + 1)), options.delimiter, summary);
+        });
+    }
+    else
+    {
+        size_t const width = options.format == "f64" ? sizeof(double) : sizeof(float);
+        size_t const rows = file.size() / (options.columns * width);
+
+        if (rows * options.columns * width != file.size()) throw options.path + " is not a whole number of " + options.format + " rows";
+
+        run(threads, total, [&](unsigned t, unsigned n, Summary& summary)
+        {
+            size_t const first = rows * t / n, last = rows * (t + 1) / n;
+
+            if (width == sizeof(double)) parse_binary<double>(data, rows, first, last, options.by_rows, summary);
+            else parse_binary<float>(data, rows, first, last, options.by_rows, summary);
+        });
+    }
+
+    report(names, total);
+
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << file.size() << " bytes in " << seconds << " s (" << file.size() / seconds / 1e9 << " GB/s, " << threads << " threads)" << endl;
 
     return EXIT_SUCCESS;
 }
@@ -1,12 +1,39 @@
 
+#include "AccumulatorTable.h"
+#include "AnomalyDetector.h"
+#include "Complex.h"
+#include "Correlogram.h"
+#include "Downsampler.h"
+#include "Dual.h"
+#include "FFT.h"
+#include "Geometry3D.h"
+#include "Functions.h"
+#include "Polylog2.h"
 #include "Statistics.h"
 
+#include <algorithm>
+#include <complex>
 #include <iostream>
 #include <iomanip>
+#include <limits>
+#include <map>
+#include <vector>
 
 using std::cout;
 using std::endl;
 
+class Random  // Knuth's 64 bit LCG: repeatable test inputs, the same on every platform
+{
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t bits() { state = state * 6364136223846793005ull + 1442695040888963407ull; return state >> 11; }  // 53 high bits
+    double uniform(double lo = 0, double hi = 1) { return lo + (hi - lo) * (double(bits()) / 9007199254740992.0); }
+
+private:
+    uint64_t state;
+};
+
 int testStatistics()
 {
     cout << std::setprecision(5);
@@ -50,3 +77,733 @@ int testStatistics()
 
     return EXIT_SUCCESS;
 }
+
+int testMerge()
+{
+    cout << std::setprecision(5);
+
+    // Bulk inserts and merged partial accumulators against one sample at a time
+
+    double x[1000], y[1000];
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        x[i] = 1000 + sin(0.1 * i);
+        y[i] = 3 * x[i] + cos(0.37 * i);
+    }
+
+    StatisticsAccumulator<double> serial, bulk, left, right;
+    RegressionAccumulator<double> serial2, bulk2, left2, right2;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        serial.insert(x[i]);
+        serial2.insert(x[i], y[i]);
+    }
+    bulk.insert(x, 1000);
+    bulk2.insert(x, y, 1000);
+    left.insert(x, 300).merge(right.insert(x + 300, 700));
+    left2.insert(x, y, 300).merge(right2.insert(x + 300, y + 300, 700));
+
+    cout << serial.average() << "\t" << bulk.average() << "\t" << left.average() << endl;
+    cout << serial.stdev_s() << "\t" << bulk.stdev_s() << "\t" << left.stdev_s() << endl;
+    cout << serial2.correlation() << "\t" << bulk2.correlation() << "\t" << left2.correlation() << endl;
+
+    bool ok = bulk.samples() == 1000 && left2.samples() == 1000;
+
+    for (auto const& r : { bulk, left }) ok &= std::abs(r.average() / serial.average() - 1) < 1e-12 && std::abs(r.stdev_s() / serial.stdev_s() - 1) < 1e-9;
+    for (auto const& r : { bulk2, left2 }) ok &= std::abs(r.gain() / serial2.gain() - 1) < 1e-9 && std::abs(r.correlation() - serial2.correlation()) < 1e-9;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testAccumulatorTable()
+{
+    cout << std::setprecision(5);
+
+    // Two shards fed in bulk and merged, against std::map fed one sample at a time
+
+    std::vector<uint64_t> key(100000);
+    std::vector<double> x(key.size()), y(key.size());
+    Random random(1);
+
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        key[i] = random.bits() % 5000;
+        x[i] = random.uniform();
+        y[i] = 2 * x[i] + double(key[i]);
+    }
+
+    std::map<uint64_t, RegressionAccumulator<double>> reference;
+    AccumulatorTable<uint64_t, RegressionAccumulator<double>> left, right;
+
+    for (size_t i = 0; i < key.size(); ++i) reference[key[i]].insert(x[i], y[i]);
+    left.insert(key.data(), x.data(), y.data(), 60000);
+    right.insert(key.data() + 60000, x.data() + 60000, y.data() + 60000, key.size() - 60000);
+    left.merge(right);
+
+    bool ok = left.size() == reference.size();
+    auto expected = reference.begin();
+
+    left.for_each_ordered([&](uint64_t k, RegressionAccumulator<double> const& r)
+    {
+        ok &= expected != reference.end() && expected->first == k && r.samples() == expected->second.samples();
+        ok &= std::abs(r.bias() - expected->second.bias()) < 1e-6 && std::abs(r.gain() - 2) < 1e-9;
+        ++expected;
+    });
+
+    for (uint64_t k = 0; k < 5000; k += 2) ok &= left.erase(k) == (reference.count(k) == 1);
+    for (uint64_t k = 0; k < 5000; ++k) ok &= (left.find(k) != nullptr) == (k % 2 == 1 && reference.count(k) == 1);
+
+    cout << left.size() << "\t" << left.capacity() << "\t" << left[4999].samples() << "\t" << left[4999].bias() << endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testCorrelogram()
+{
+    cout << std::setprecision(5);
+
+    // Sliding window of 300 samples at lags 0 ... 40, against one RegressionAccumulator per lag
+
+    size_t const lags = 41, window = 300;
+    std::vector<double> x(2000), y(2000);
+
+    for (size_t t = 0; t < x.size(); ++t)
+    {
+        x[t] = 100 + sin(0.05 * t) + 0.3 * sin(1.7 * t * t);
+        y[t] = t >= 7 ? 2 * x[t - 7] + cos(0.9 * t) : 0;
+    }
+
+    CorrelogramAccumulator<double> cross(lags - 1), self(lags - 1);
+    bool ok = true;
+
+    for (size_t t = 0; t < x.size(); ++t)
+    {
+        cross.insert(x[t], y[t]);
+        self.insert(x[t]);
+        if (t >= window)
+        {
+            cross.remove();
+            self.remove();
+        }
+
+        if (t % 97 != 0 || t < lags) continue;
+
+        size_t const first = t >= window ? t - window + 1 : 0;
+
+        for (size_t k = 0; k < lags; ++k)
+        {
+            RegressionAccumulator<double> c, a;
+            StatisticsAccumulator<double> xs, ys, xy;
+
+            for (size_t u = first + k; u <= t; ++u)
+            {
+                c.insert(x[u - k], y[u]);
+                a.insert(x[u - k], x[u]);
+                xs.insert(x[u - k]);
+                ys.insert(y[u]);
+            }
+            for (size_t u = first + k; u <= t; ++u) xy.insert((x[u - k] - xs.average()) * (y[u] - ys.average()));
+
+            ok &= cross.samples(k) == c.samples() && std::abs(cross.correlation(k) - c.correlation()) < 1e-9;
+            ok &= std::abs(self.correlation(k) - a.correlation()) < 1e-9 && std::abs(cross.covariance(k) - xy.average()) < 1e-9;
+        }
+    }
+
+    double r[lags];
+    cross.correlogram(r);
+
+    for (size_t k = 5; k < 10; ++k) cout << k << "\t" << r[k] << endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testCorrelogramDrift()
+{
+    // A million samples of x = 0.01 t + noise on a sliding window of 256: the window average keeps moving, so offsets
+    // taken once would leave the sums to cancel catastrophically.  Checked against two pass correlations at the end.
+
+    size_t const lags = 8, window = 256, count = 1000000;
+    std::vector<double> x(count);
+    Random random(3);
+
+    for (size_t t = 0; t < count; ++t)
+    {
+        double noise = -6;
+        for (int j = 0; j < 12; ++j) noise += random.uniform();
+        x[t] = 0.01 * double(t) + noise;
+    }
+
+    CorrelogramAccumulator<double> self(lags - 1);
+
+    for (size_t t = 0; t < count; ++t)
+    {
+        self.insert(x[t]);
+        if (t >= window) self.remove();
+    }
+
+    bool ok = self.samples() == window;
+
+    for (size_t k = 0; k < lags; ++k)
+    {
+        double mx = 0, my = 0, sxx = 0, syy = 0, sxy = 0;
+        size_t const first = count - window + k, m = window - k;
+
+        for (size_t u = first; u < count; ++u) mx += x[u - k], my += x[u];
+        mx /= double(m);
+        my /= double(m);
+        for (size_t u = first; u < count; ++u)
+        {
+            sxx += (x[u - k] - mx) * (x[u - k] - mx);
+            syy += (x[u] - my) * (x[u] - my);
+            sxy += (x[u - k] - mx) * (x[u] - my);
+        }
+
+        double const r = sxy / sqrt(sxx * syy);
+
+        cout << k << "\t" << self.correlation(k) << "\t" << r << endl;
+        ok &= std::abs(self.correlation(k) - r) < 1e-11 && std::abs(self.covariance(k) - sxy / double(m)) < 1e-11;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testDownsampler()
+{
+    cout << std::setprecision(5);
+
+    // Three hours of 10 Hz samples on milliseconds, shuffled up to 2 s out of order, in batches; 1s, 1m and 1h levels
+    // against per minute and per hour summaries computed directly
+
+    Downsampler<double> d({ { 1000, 4000 }, { 60000, 200 }, { 3600000, 10 } }, 2000);
+    std::map<int64_t, TimeBucket<double>> minute, hour;
+    std::vector<int64_t> t;
+    std::vector<double> x;
+    Random random(7);
+
+    for (int64_t i = 0; i < 3 * 36000; ++i)
+    {
+        t.push_back(1700000000000 + 100 * i);
+        x.push_back(sin(1e-4 * i) + random.uniform());
+    }
+    for (size_t i = 0; i + 19 < t.size(); i += 20)  // Reverse runs of 20 samples: up to 1.9 s late
+    {
+        std::reverse(t.begin() + i, t.begin() + i + 20);
+        std::reverse(x.begin() + i, x.begin() + i + 20);
+    }
+
+    for (size_t i = 0; i < t.size(); ++i)
+    {
+        for (auto* m : { &minute, &hour })
+        {
+            int64_t const width = m == &minute ? 60000 : 3600000;
+            auto it = m->find(t[i] / width);
+            if (it == m->end()) it = m->emplace(t[i] / width, TimeBucket<double>().reset(t[i] / width * width)).first;
+            it->second.insert(t[i], x[i]);
+        }
+    }
+
+    for (size_t i = 0; i < t.size(); i += 50) d.insert(&t[i], &x[i], std::min<size_t>(50, t.size() - i));
+    d.insert(t[0], 0.0);  // Far too late
+    d.flush();
+
+    bool ok = d.late() == 1;
+    size_t seconds = 0, minutes = 0, hours = 0;
+
+    d.for_each(0, [&](TimeBucket<double> const& b) { seconds += b.stats.samples(); });
+
+    auto compare = [&](std::map<int64_t, TimeBucket<double>> const& m, int64_t width, size_t& count)
+    {
+        return [&, width](TimeBucket<double> const& b)
+        {
+            auto const& r = m.at(b.start / width);
+            ok &= b.stats.samples() == r.stats.samples() && std::abs(b.stats.average() - r.stats.average()) < 1e-12;
+            ok &= std::abs(b.stats.stdev_s() - r.stats.stdev_s()) < 1e-12 && b.lo == r.lo && b.hi == r.hi;
+            ok &= b.first == r.first && b.last == r.last && b.first_time == r.first_time && b.last_time == r.last_time;
+            ++count;
+        };
+    };
+
+    d.for_each(1, compare(minute, 60000, minutes));
+    d.for_each(2, compare(hour, 3600000, hours));
+
+    ok &= seconds >= 4000 * 10 && minutes == minute.size() && hours == hour.size();
+
+    d.for_each(2, [](TimeBucket<double> const& b)
+    {
+        cout << b.start << "\t" << b.stats.samples() << "\t" << b.stats.average() << "\t" << b.lo << "\t" << b.hi << endl;
+    });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testDetectorBank()
+{
+    // Uniform noise on 1003 streams (so that the scalar tail runs too); after the 200 tick warm-up stream 7 gets a spike,
+    // stream 1002 a negative spike and stream 500 a step of two standard deviations, which only the CUSUM catches; the
+    // CUSUM slack and limit are above the textbook 0.5 and 5, which alarm every few hundred ticks on noise
+
+    size_t const streams = 1003, window = 200;
+    DetectorBank<double> bank(streams, window, 4.0, 1.0, 8.0);
+    std::vector<StatisticsAccumulator<double>> reference(streams);
+    std::vector<double> x(streams);
+    std::vector<std::pair<size_t, size_t>> alarms;  // (tick, stream)
+    Random random(11);
+    bool ok = true;
+
+    for (size_t t = 0; t < 800; ++t)
+    {
+        for (size_t i = 0; i < streams; ++i)
+        {
+            x[i] = double(i % 10) + random.uniform(-1, 1);
+            if (t < window) reference[i].insert(x[i]);
+        }
+        if (t == 400) x[7] += 10, x[1002] -= 10;
+        if (t >= 500) x[500] += 1.16;
+
+        for (auto i : bank.tick(x.data())) alarms.push_back({ t, i });
+
+        if (t + 1 == window)
+        {
+            for (size_t i = 0; i < streams; ++i)
+            {
+                ok &= std::abs(bank.mean(i) - reference[i].average()) < 1e-12 * (1 + std::abs(reference[i].average()));
+                ok &= std::abs(bank.stdev(i) - reference[i].stdev_p()) < 1e-9 * reference[i].stdev_p();
+            }
+        }
+    }
+
+    ok &= alarms.size() >= 3 && bank.ticks() == 800;
+
+    for (size_t k = 0; k < alarms.size() && k < 3; ++k) cout << "tick " << alarms[k].first << "\tstream " << alarms[k].second << endl;
+
+    if (ok)
+    {
+        ok &= alarms[0] == std::make_pair(size_t(400), size_t(7)) && alarms[1] == std::make_pair(size_t(400), size_t(1002));
+        ok &= alarms[2].first > 500 && alarms[2].first < 520;
+        for (size_t k = 2; k < alarms.size(); ++k) ok &= alarms[k].second == 500;  // Until the average has caught up
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testComplex()
+{
+    cout << std::setprecision(3);
+
+    // n = 2 widths + 1, so that the kernels run two vector iterations and the scalar tail; against long double
+
+    size_t const n = 2 * Simd<double>::width + 1;
+    double const eps = std::numeric_limits<double>::epsilon();
+    ComplexArray<double> a(n), b(n), c(n), d(n);
+    std::vector<double> m(n);
+    Random random(9);
+    bool ok = true;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        a.set(i, { random.uniform(-1, 1), random.uniform(-1, 1) });
+        b.set(i, { random.uniform(-1, 1), random.uniform(-1, 1) });
+        d.set(i, { random.uniform(-1, 1), random.uniform(-1, 1) });
+    }
+
+    auto exact = [](Complex<double> const& r) { return std::complex<long double>(r.x, r.y); };
+    auto error = [&](Complex<double> const& r, std::complex<long double> const& s) { return double(std::abs(exact(r) - s) / std::abs(s)); };
+
+    double worst = 0;
+
+    multiply(c, a, b);
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, error(c[i], exact(a[i]) * exact(b[i])));
+    conj_multiply(c, a, b);
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, error(c[i], exact(a[i]) * std::conj(exact(b[i]))));
+    c = d;
+    multiply_accumulate(c, a, b);
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, error(c[i], exact(d[i]) + exact(a[i]) * exact(b[i])));
+    magnitude(m.data(), a);
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, std::abs(m[i] - double(std::abs(exact(a[i])))) / m[i]);
+    for (size_t i = 0; i < n; ++i) worst = std::max(worst, error(a[i] / b[i], exact(a[i]) / exact(b[i])));
+
+    cout << "kernels and division\t" << worst / eps << " eps" << endl;
+    ok &= worst < 4 * eps;
+
+    constexpr Complex<double> q = Complex<double>(1, 2) / Complex<double>(3, 4);  // (11 + 2i) / 25
+    ok &= std::abs(q.x - 0.44) < eps && std::abs(q.y - 0.08) < eps;
+
+    // std::complex buffer -> ComplexArray -> a * b -> back into the same buffer, against std::complex arithmetic
+
+    std::vector<std::complex<double>> z(n);
+    for (size_t i = 0; i < n; ++i) z[i] = { a[i].x, a[i].y };
+
+    ComplexView<double> view(z.data(), z.size());
+    ComplexArray<double> e(view);
+
+    ok &= e.size() == n && view[n - 1].x == a[n - 1].x && view[n - 1].y == a[n - 1].y;
+    multiply(e, e, b);
+    e.store(view);
+    for (size_t i = 0; i < n; ++i) ok &= std::abs(z[i] - std::complex<double>(a[i].x, a[i].y) * std::complex<double>(b[i].x, b[i].y)) < 4 * eps * std::abs(z[i]);
+    view.set(0, { 5, -6 });
+    ok &= z[0] == std::complex<double>(5, -6);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+template <typename T> bool verifyComplexFunctions(char const* type, double limit)
+{
+    // Every pair (u, v) with u the argument of the sines and cosines and v that of the exponentials: sin and cos get
+    // u + iv, exp, sinh and cosh get v + iu.  The u reach past sincos_limit and the v past the point where exp
+    // overflows but cosh does not; the pair count is not a multiple of the vector width, so the scalar tail runs too.
+    // Errors are in ulp of |reference|, and a reference beyond the range of T must come out infinite.
+
+    typedef std::complex<long double> L;
+
+    T const top = std::log(std::numeric_limits<T>::max());
+    std::vector<T> const u = { 0, T(1e-3), T(-0.5), 1, 3, -10, 100, T(-1e4), T(3) * T(SimdConstants<T>::sincos_limit), T(-1e7) };
+    std::vector<T> const v = { 0, T(1e-4), T(-0.7), 5, -19, 21, 30, -top / 2, top - 2, top + T(0.5), -top - T(0.6) };
+    size_t const n = u.size() * v.size();
+
+    ComplexArray<T> trig(n), hyper(n), out(n);
+    std::vector<T> angle(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        trig.set(i, { u[i / v.size()], v[i % v.size()] });
+        hyper.set(i, { v[i % v.size()], u[i / v.size()] });
+        angle[i] = u[i / v.size()];
+    }
+
+    auto ulp = [](long double r) { T const a = T(r); return (long double)(std::nextafter(a, T(INFINITY)) - a); };
+    auto error = [&](Complex<T> const& r, L const& s)
+    {
+        if (std::abs(s) > std::numeric_limits<T>::max()) return std::isinf(r.x) || std::isinf(r.y) ? 0.0 : HUGE_VAL;
+        return double(std::abs(L(r.x, r.y) - s) / ulp(std::abs(s)));
+    };
+
+    double worst = 0;
+
+    for (size_t i = 0; i < n; ++i)  // Scalar
+    {
+        T s, c, sh, ch;
+        long double const x = angle[i], y = hyper[i].x;
+
+        sincos(angle[i], s, c);
+        sinhcosh(hyper[i].x, sh, ch);
+        worst = std::max({ worst, double(std::abs(s - std::sin(x)) / ulp(1)), double(std::abs(c - std::cos(x)) / ulp(1)) });
+        worst = std::max({ worst, double(std::abs(sh - std::sinh(y)) / ulp(std::abs(std::sinh(y)))), double(std::abs(ch - std::cosh(y)) / ulp(std::cosh(y))) });
+        worst = std::max(worst, error(cis(angle[i]), std::polar(1.0L, x)));
+        worst = std::max(worst, error(exp(hyper[i]), std::exp(L(hyper[i].x, hyper[i].y))));
+        worst = std::max(worst, error(sin(trig[i]), std::sin(L(trig[i].x, trig[i].y))));
+        worst = std::max(worst, error(cos(trig[i]), std::cos(L(trig[i].x, trig[i].y))));
+        worst = std::max(worst, error(sinh(hyper[i]), std::sinh(L(hyper[i].x, hyper[i].y))));
+        worst = std::max(worst, error(cosh(hyper[i]), std::cosh(L(hyper[i].x, hyper[i].y))));
+    }
+
+    double batch = 0;
+
+    cis(out, angle.data());
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::polar(1.0L, (long double)angle[i])));
+    exp(out, hyper);
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::exp(L(hyper[i].x, hyper[i].y))));
+    sin(out, trig);
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::sin(L(trig[i].x, trig[i].y))));
+    cos(out, trig);
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::cos(L(trig[i].x, trig[i].y))));
+    sinh(out, hyper);
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::sinh(L(hyper[i].x, hyper[i].y))));
+    cosh(out, hyper);
+    for (size_t i = 0; i < n; ++i) batch = std::max(batch, error(out[i], std::cosh(L(hyper[i].x, hyper[i].y))));
+
+    cout << type << "\tscalar " << worst << " ulp\tbatch " << batch << " ulp" << endl;
+
+    return worst <= limit && batch <= limit;
+}
+
+int testComplexFunctions()
+{
+    cout << std::setprecision(3);
+
+    bool ok = verifyComplexFunctions<float>("float", 3);
+    ok &= verifyComplexFunctions<double>("double", 3);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testFFT()
+{
+    cout << std::setprecision(3);
+
+    // Odd, prime, mixed radix and power of two sizes against a long double DFT, and round trips; primes above the
+    // Bluestein threshold appear alone, doubled and as a pair.  Sizes past 2048 are checked at a few bins; the largest is
+    // at the threading threshold, and a plan with 4 threads, alone and batched, must match a single threaded one
+
+    auto dft = [](std::vector<Complex<double>> const& x, size_t k)
+    {
+        size_t const n = x.size();
+        long double re = 0, im = 0;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            long double const phase = -6.283185307179586476925L * (long double)(j * k % n) / (long double)n;
+            re += x[j].x * std::cos(phase) - x[j].y * std::sin(phase);
+            im += x[j].x * std::sin(phase) + x[j].y * std::cos(phase);
+        }
+        return Complex<double>(double(re), double(im));
+    };
+
+    bool ok = true;
+    Random random(5);
+
+    for (size_t n : std::vector<size_t>{ 1, 2, 7, 12, 45, 97, 105, 360, 1024, 1155, 4099, 8198, 67 * 71, FFTPlan<double>::parallel_threshold })
+    {
+        bool const large = n >= FFTPlan<double>::parallel_threshold, sparse = n > 2048;
+        size_t const count = large ? 1 : 3;
+        auto const plan = FFTPlan<double>::get(n);
+        std::vector<Complex<double>> x(n * count), X(n * count), y(n * count), batched(n * count);
+        std::vector<double> r(n), s(n);
+        std::vector<Complex<double>> R(n / 2 + 1);
+
+        for (auto& z : x) z = Complex<double>(random.uniform(-1, 1), random.uniform(-1, 1));
+        for (auto& v : r) v = random.uniform(-1, 1);
+
+        double error = 0, trip = 0;  // Relative to the largest bin, and to the largest input
+
+        for (size_t b = 0; b < count; ++b)
+        {
+            std::vector<Complex<double>> const one(x.begin() + b * n, x.begin() + (b + 1) * n);
+            plan->forward(&x[b * n], &X[b * n]);
+
+            double scale = 0;
+            for (size_t k = 0; k < n; ++k) scale = std::max(scale, abs(X[b * n + k]));
+            for (size_t k = 0; k < n; k += sparse ? n / 16 + 1 : 1) error = std::max(error, abs(X[b * n + k] - dft(one, k)) / scale);
+        }
+
+        plan->forward(x.data(), batched.data(), count);
+        for (size_t i = 0; i < n * count; ++i) ok &= batched[i].x == X[i].x && batched[i].y == X[i].y;
+
+        plan->inverse(X.data(), y.data(), count);
+        for (size_t i = 0; i < n * count; ++i) trip = std::max(trip, abs(y[i] - x[i]));
+        y = X;
+        plan->inverse(y.data());
+        for (size_t i = 0; i < n; ++i) trip = std::max(trip, abs(y[i] - x[i]));
+
+        // Real input: the first n / 2 + 1 bins of the complex transform of r, and back
+
+        std::vector<Complex<double>> rc(n);
+        for (size_t i = 0; i < n; ++i) rc[i] = Complex<double>(r[i], 0);
+        plan->forward_real(r.data(), R.data());
+
+        double scale = 0;
+        for (auto const& z : R) scale = std::max(scale, abs(z));
+        for (size_t k = 0; k <= n / 2; k += sparse ? n / 32 + 1 : 1) error = std::max(error, abs(R[k] - dft(rc, k)) / scale);
+
+        plan->inverse_real(R.data(), s.data());
+        for (size_t i = 0; i < n; ++i) trip = std::max(trip, std::abs(s[i] - r[i]));
+
+        if (large)
+        {
+            FFTPlan<double> const threaded(n, 4), single(n, 1);
+            std::vector<Complex<double>> a(n), c(n);
+
+            threaded.forward(x.data(), a.data());
+            single.forward(x.data(), c.data());
+            for (size_t i = 0; i < n; ++i) ok &= a[i].x == c[i].x && a[i].y == c[i].y && a[i].x == X[i].x && a[i].y == X[i].y;
+
+            std::vector<Complex<double>> pair(2 * n), both(2 * n);  // Batched over two workers with two threads each
+            std::copy(x.begin(), x.end(), pair.begin());
+            std::copy(x.begin(), x.end(), pair.begin() + n);
+            threaded.forward(pair.data(), both.data(), 2);
+            for (size_t i = 0; i < 2 * n; ++i) ok &= both[i].x == X[i % n].x && both[i].y == X[i % n].y;
+        }
+
+        cout << n << "\t" << error << "\t" << trip << endl;
+        ok &= error < 1e-14 * (1 + std::log2(double(n))) && trip < 1e-14 * (1 + std::log2(double(n)));
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int testDual()
+{
+    cout << std::setprecision(5);
+
+    // One pass value and derivative against a central difference of the same template instantiated with double
+
+    bool ok = true;
+
+    auto check = [&](char const* name, auto const& f)
+    {
+        double worst = 0;
+
+        for (double x : { -1.7, -0.4, 0.3, 0.9, 2.2 })
+        {
+            double const h = 1e-6, difference = (f(x + h) - f(x - h)) / (2 * h);
+            Dual<double> const y = f(Dual<double>(x, 0));
+
+            ok &= std::abs(y.v - f(x)) <= 1e-14 * std::max(1.0, std::abs(f(x)));
+            worst = std::max(worst, std::abs(y.d[0] - difference) / std::max(1.0, std::abs(difference)));
+        }
+
+        cout << name << "\t" << worst << endl;
+        ok &= worst < 1e-7;
+    };
+
+    check("CostW", [](auto x) { return CostW(x); });
+    check("InvAct", [](auto x) { return InvAct(x); });
+    check("Logistic", [](auto x) { return Logistic(x); });
+    check("SoftPlus", [](auto x) { return SoftPlus(x); });
+
+    check("Statistics", [](auto a)  // Average and standard deviation of a sample that depends on 'a'
+    {
+        StatisticsAccumulator<decltype(a)> s;
+        for (int i = 0; i < 10; ++i) s.insert(a * double(i) + sin(a * a + double(i)));
+        return s.average() + s.stdev_p();
+    });
+
+    check("Quaternion rotate", [](auto t)  // A point rotated by angle t about a fixed axis
+    {
+        typedef decltype(t) D;
+        using std::cos; using std::sin;
+        Quaternion<D> const q(cos(t / 2), Vector<D>(D(0.6) * sin(t / 2), D(0), D(0.8) * sin(t / 2)));
+        auto const v = q(Vector<D>(D(1), D(2), D(3)));
+        return v.x + 2 * v.y - v.z;
+    });
+
+    check("Quaternion exp log", [](auto t)
+    {
+        typedef decltype(t) D;
+        auto const e = exp(Quaternion<D>(t, D(0.5) * t, D(-0.25), D(1)));
+        auto const l = log(Quaternion<D>(D(2), t, t * t, D(0.5)));
+        return e.w + e.x - e.y + l.w + l.y - l.z;
+    });
+
+    check("Complex", [](auto x)  // Real and imaginary parts of z exp(z) along z = x + 0.5i
+    {
+        typedef decltype(x) D;
+        Complex<D> const z(x, D(0.5));
+        auto const w = z * exp(z);
+        return w.x + 3 * w.y;
+    });
+
+    // Mixed comparisons with plain numbers look at the value, as in generic code such as 'if (x <= 0.0)'
+
+    Dual<double> const c(0.5, 0);
+    ok &= c <= 0.5 && c >= 0.5 && c == 0.5 && !(c != 0.5) && 0.5 <= c && 0.5 >= c && 0.5 == c && 1 != c && c < 1 && 0 < c;
+
+    // Two variables in one pass: f = x y + sin(x) / y
+
+    Dual<double, 2> const x(0.7, 0), y(1.3, 1);
+    auto const f = x * y + sin(x) / y;
+
+    ok &= std::abs(f.d[0] - (1.3 + cos(0.7) / 1.3)) < 1e-15 && std::abs(f.d[1] - (0.7 - sin(0.7) / (1.3 * 1.3))) < 1e-15;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+template <typename T> bool verifyBatch(char const* type)
+{
+    // n = 3 widths + 5, so that every function runs both its vector lanes and its scalar tail
+
+    size_t const n = 3 * Simd<T>::width + 5;
+    T const nan = std::numeric_limits<T>::quiet_NaN();
+    std::vector<T> x(n), y(n), z(n);
+    bool ok = true;
+
+    auto ulp = [](long double r) { T const a = std::abs(T(r)); return (long double)(std::nextafter(a, T(INFINITY)) - a); };
+    auto logistic = [](long double r) { return 1 / (1 + std::exp(-r)); };
+    auto softplus = [](long double r) { return (r > 0 ? r : 0) + std::log1p(std::exp(-std::abs(r))); };
+
+    // Logistic and SoftPlus over [-40, 40] against long double, in units of T's ulp (Full) and relative (Fast)
+
+    double worst[4] = {};
+
+    for (T from = -40; from < 40; from += T(0.37) * T(n))
+    {
+        for (size_t i = 0; i < n; ++i) x[i] = from + T(0.37) * T(i);
+
+        Logistic(x.data(), y.data(), n, Accuracy::Full);
+        Logistic(x.data(), z.data(), n, Accuracy::Fast);
+        for (size_t i = 0; i < n; ++i)
+        {
+            long double const r = logistic(x[i]);
+            worst[0] = std::max(worst[0], double(std::abs(y[i] - r) / ulp(r)));
+            worst[1] = std::max(worst[1], double(std::abs(z[i] - r) / r));
+            ok &= std::abs(y[i] - Logistic(x[i])) <= 4 * ulp(r);  // The scalar template is within an ulp of its own
+        }
+
+        SoftPlus(x.data(), y.data(), n, Accuracy::Full);
+        SoftPlus(x.data(), z.data(), n, Accuracy::Fast);
+        for (size_t i = 0; i < n; ++i)
+        {
+            long double const r = softplus(x[i]);
+            worst[2] = std::max(worst[2], double(std::abs(y[i] - r) / ulp(r)));
+            worst[3] = std::max(worst[3], double(std::abs(z[i] - r) / r));
+        }
+    }
+
+    cout << type << "\tLogistic " << worst[0] << " ulp, fast " << worst[1] << "\tSoftPlus " << worst[2] << " ulp, fast " << worst[3] << endl;
+    ok &= worst[0] <= 3 && worst[1] < 4e-6 && worst[2] <= 3 && worst[3] < 6e-6;
+
+    // Comparisons are exact and the same in every lane; of a comparison with NaN the second operand wins
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = i % 7 == 3 ? nan : T(0.1) * T(i) - 1;
+        y[i] = i % 5 == 1 ? nan : T(1e-3) * T(i * i) - T(0.5);
+    }
+    x[n - 1] = std::numeric_limits<T>::max();
+    y[n - 1] = -std::numeric_limits<T>::max();
+
+    auto same = [](T const& a, T const& b) { return a == b || (a != a && b != b); };
+
+    Maximum(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i) ok &= same(z[i], x[i] > y[i] ? x[i] : y[i]);
+    Minimum(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i) ok &= same(z[i], x[i] < y[i] ? x[i] : y[i]);
+    ReLU(x.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i) ok &= x[i] != x[i] ? z[i] != z[i] : z[i] == std::max(x[i], T(0));
+    Restrict(x.data(), z.data(), n, T(0.4), T(-0.3));
+    for (size_t i = 0; i < n; ++i) ok &= x[i] != x[i] ? z[i] != z[i] : z[i] == std::min(std::max(x[i], T(-0.3)), T(0.4));
+
+    return ok;
+}
+
+int testBatchFunctions()
+{
+    cout << std::setprecision(3);
+
+    bool ok = verifyBatch<float>("float");
+    ok &= verifyBatch<double>("double");
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+template <typename Table, typename F> bool verifyTable(char const* name, F const& f)
+{
+    double worst = 0;
+
+    for (double x = -30; x < 30; x += 1.0 / 1024 / 3)
+    {
+        worst = std::max(worst, std::abs(double(Table::evaluate(x)) - f(x)));
+    }
+
+    cout << name << "\t" << worst << "\t" << Table::max_error << "\t" << (worst <= Table::max_error ? "ok" : "FAILED") << endl;
+
+    return worst <= Table::max_error;
+}
+
+int testLookupTable()
+{
+    cout << std::setprecision(3);
+
+    auto softplus = [](double x) { return x > 0 ? x + log1p(exp(-x)) : log1p(exp(x)); };
+
+    bool ok = true;
+
+    ok &= verifyTable<LogisticTable<256>>("Logistic 256 linear", [](double x) { return Logistic(x); });
+    ok &= verifyTable<LogisticTable<1024, 3>>("Logistic 1024 cubic", [](double x) { return Logistic(x); });
+    ok &= verifyTable<SoftPlusTable<1024, 3, float>>("SoftPlus 1024 cubic float", softplus);
+    ok &= verifyTable<SppTable<2048, 1>>("Spp 2048 linear", [](double x) { return Spp(x); });
+    ok &= verifyTable<SppTable<1024, 3>>("Spp 1024 cubic", [](double x) { return Spp(x); });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
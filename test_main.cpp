@@ -0,0 +1,80 @@
+
+/*
+MIT License
+
+Copyright(c) 2022 Risto Lankinen
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Runs every test in test.cpp; the exit status is nonzero if any of them failed
+
+#include <cstdlib>
+#include <iostream>
+
+int testStatistics();
+int testMerge();
+int testAccumulatorTable();
+int testCorrelogram();
+int testCorrelogramDrift();
+int testDownsampler();
+int testDetectorBank();
+int testComplex();
+int testComplexFunctions();
+int testFFT();
+int testDual();
+int testBatchFunctions();
+int testLookupTable();
+
+using std::cout;
+using std::endl;
+
+int main()
+{
+    struct { char const* name; int (*run)(); } const tests[] =
+    {
+        { "Statistics", testStatistics },
+        { "Merge", testMerge },
+        { "AccumulatorTable", testAccumulatorTable },
+        { "Correlogram", testCorrelogram },
+        { "CorrelogramDrift", testCorrelogramDrift },
+        { "Downsampler", testDownsampler },
+        { "DetectorBank", testDetectorBank },
+        { "Complex", testComplex },
+        { "ComplexFunctions", testComplexFunctions },
+        { "FFT", testFFT },
+        { "Dual", testDual },
+        { "BatchFunctions", testBatchFunctions },
+        { "LookupTable", testLookupTable },
+    };
+
+    int failures = 0;
+
+    for (auto const& test : tests)
+    {
+        cout << "=== " << test.name << endl;
+        if (test.run() != EXIT_SUCCESS)
+        {
+            cout << "=== " << test.name << " FAILED" << endl;
+            ++failures;
+        }
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}